@@ -1,10 +1,11 @@
 #pragma once
 
+#include <optional>
+
 #include <core/app/App.hpp>
 #include <core/app/Layer.hpp>
 
-#include <core/utils/MeshUtils.hpp>
-#include "core/utils/ImageUtils.hpp"
+#include <core/utils/AssetLoader.hpp>
 #include <core/utils/FileUtils.hpp>
 
 using namespace Core::App;
@@ -15,13 +16,32 @@ public:
 
 	void onAttach() override {
 		auto renderer = App::instance()->renderer();
-		auto shaderData = Core::Utils::readShader("../../shaders/slang.spv");
+		auto shaderData = Core::Utils::readShader(ASTRO_SHADER_BINARY);
 		renderer->createPipeline("basic", shaderData);
+		renderer->createComputePipeline("cullInstances", shaderData, "cullInstances");
+		renderer->createComputePipeline("compactDraws", shaderData, "compactDraws");
 
-		auto meshData = Core::Utils::loadMesh("../../models/viking_room/viking_room.obj");
-		auto meshID = renderer->createMesh(meshData);
-		auto textureData = Core::Utils::readTexture("../../models/viking_room/viking_room.png");
-		auto textureID = renderer->createTexture(textureData);
-		renderer->addInstance(meshID, textureID);
+		// Decoded in the background, uploaded from onUpdate as each one finishes
+		_assets.loadMesh("../../models/viking_room/viking_room.obj", [this, renderer](auto &mesh) {
+			_meshID = renderer->createMesh(mesh.get());
+		});
+		_assets.loadTexture("../../models/viking_room/viking_room.png", [this, renderer](auto &texture) {
+			_textureID = renderer->createTexture(texture.get());
+		});
 	}
-};
\ No newline at end of file
+
+	void onUpdate(float dt) override {
+		_assets.dispatch();
+
+		if (_meshID && _textureID && !_instanceAdded) {
+			App::instance()->renderer()->addInstance(*_meshID, *_textureID);
+			_instanceAdded = true;
+		}
+	}
+
+private:
+	Core::Utils::AssetLoader _assets;
+	std::optional<Core::MeshID> _meshID;
+	std::optional<Core::TextureID> _textureID;
+	bool _instanceAdded = false;
+};
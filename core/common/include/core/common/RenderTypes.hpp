@@ -7,6 +7,8 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
 #include <functional>
+#include <memory>
+#include <span>
 
 namespace Core {
 
@@ -27,21 +29,109 @@ namespace Core {
 		}
 	};
 
+	// Width of the indices a mesh is stored and drawn with
+	enum class IndexType : uint32_t {
+		Uint16,
+		Uint32
+	};
+
+	// 16 bit indices address every vertex of meshes up to this size
+	constexpr size_t MAX_UINT16_INDEXED_VERTICES = size_t(1) << 16;
+
+	inline IndexType smallestIndexType(size_t vertexCount) {
+		return vertexCount <= MAX_UINT16_INDEXED_VERTICES ? IndexType::Uint16 : IndexType::Uint32;
+	}
+
+	// Levels of detail a mesh may carry, the full mesh included
+	constexpr uint32_t MAX_MESH_LODS = 5;
+
+	// Range of MeshData::indices drawing one level of detail
+	struct MeshLod {
+		uint32_t firstIndex = 0;
+		uint32_t indexCount = 0;
+		float error = 0.0f; // object space distance to the full mesh, 0 for the full mesh
+	};
+
+	// Meshlet size limits, the usual mesh shader output sizes
+	constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+	constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+	// Cluster of neighbouring triangles stored as a contiguous range of MeshData::indices, culled on its own
+	struct Meshlet {
+		glm::vec4 boundingSphere{0.0f}; // center (xyz) and radius (w)
+		// Average facing (xyz) and the sine of the widest angle to it (w). Viewed from where
+		// dot(center - eye, axis) >= cutoff * length(center - eye) + radius, every triangle faces away.
+		glm::vec4 cone{0.0f, 0.0f, 1.0f, 1.0f};
+		uint32_t firstIndex = 0;
+		uint32_t triangleCount = 0;
+		uint32_t vertexCount = 0;
+		uint32_t padding = 0;
+	};
+
 	struct MeshData {
 		std::vector<Vertex> vertices;
+		// Processed as 32 bit, indexType is the width used in the mesh cache and the GPU index buffers
 		std::vector<uint32_t> indices;
+		IndexType indexType = IndexType::Uint32;
+		// Finest level first, every level indexes the same vertices. Empty means a single level made of
+		// every index.
+		std::vector<MeshLod> lods;
+		// Partition of the finest level
+		std::vector<Meshlet> meshlets;
+	};
+
+	// Layout of a mesh's vertices on the GPU, chosen per mesh when it is created
+	enum class VertexFormat : uint32_t {
+		Full,               // Vertex as is, 44 bytes
+		Quantized,          // QuantizedVertex with unorm16 texture coordinates, for UVs within [0, 1]
+		QuantizedHalfUv     // QuantizedVertex with half float texture coordinates, for tiled UVs
+	};
+
+	// Number of VertexFormat values, keep in sync with the last enumerator
+	constexpr uint32_t VERTEX_FORMAT_COUNT = static_cast<uint32_t>(VertexFormat::QuantizedHalfUv) + 1;
+
+	// 16 byte vertex without color, for meshes whose vertex colors are all white
+	struct QuantizedVertex {
+		int16_t pos[4];       // snorm16 within the mesh bounds, w unused
+		int16_t normal[2];    // octahedral snorm16
+		uint16_t texCoord[2]; // unorm16 or half float depending on the format
+	};
+	static_assert(sizeof(QuantizedVertex) == 16);
+
+	enum class TextureFormat : uint32_t {
+		RGBA8Srgb,
+		BC1Srgb,  // 4x4 blocks of 8 bytes, opaque color
+		BC3Srgb,  // 4x4 blocks of 16 bytes, color and alpha
+		BC5Unorm, // 4x4 blocks of 16 bytes, two linear channels such as normal map XY
+		BC7Srgb   // 4x4 blocks of 16 bytes, high quality color and alpha
 	};
 
 	struct TextureData {
-		std::vector<uint8_t> pixels; // RGBA or user-defined format
+		std::vector<uint8_t> pixels; // texels or blocks of format, mip levels packed from the largest down
 		uint32_t width;
 		uint32_t height;
 		uint32_t nbChannels;
+		// Levels stored in pixels, each half the size of the previous one. With a single RGBA8 level the
+		// renderer builds the full chain itself, compressed textures must bring their own chain.
+		uint32_t mipLevels = 1;
+		TextureFormat format = TextureFormat::RGBA8Srgb;
+
+		// Texels living outside of pixels, such as a memory mapped file or a decoder buffer, kept alive by
+		// owner. Used instead of pixels when set so loaders can hand their buffer over without copying it.
+		std::span<const uint8_t> external;
+		std::shared_ptr<const void> owner;
+		// Byte offset of each level in data(), empty when the levels are packed from the largest down
+		std::vector<size_t> levelOffsets;
+
+		[[nodiscard]] std::span<const uint8_t> data() const {
+			return external.empty() ? std::span<const uint8_t>(pixels) : external;
+		}
 	};
 
 	struct ModelData {
 		MeshID meshID;
 		TextureID textureID;
+		glm::mat4 transform{1.0f};
 	};
 
 	struct ShaderData {
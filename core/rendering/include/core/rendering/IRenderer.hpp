@@ -6,6 +6,8 @@
 #include <cstdint>
 #include <string>
 
+#include <glm/glm.hpp>
+
 #include <core/common/RenderTypes.hpp>
 
 namespace Core::Rendering {
@@ -20,7 +22,11 @@ namespace Core::Rendering {
 
 		virtual MeshID createMesh(const MeshData& meshData) = 0;
 		virtual TextureID createTexture(const TextureData& textureData) = 0;
+		// Instances still using the texture fall back to the dummy texture, its id may be handed out again
+		virtual void destroyTexture(TextureID texture) = 0;
 		virtual void createPipeline(const std::string& name, const ShaderData& shaderData) = 0;
+		virtual void createComputePipeline(const std::string& name, const ShaderData& shaderData, const std::string& entryPoint) = 0;
 		virtual void addInstance(MeshID mesh, uint32_t texture = 0) = 0;
+		virtual void addInstance(MeshID mesh, TextureID texture, const glm::mat4& transform) = 0;
 	};
 }
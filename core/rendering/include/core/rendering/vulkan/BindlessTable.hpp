@@ -0,0 +1,60 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <core/rendering/vulkan/header.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace Core::Rendering::Vulkan {
+
+	class Context;
+
+	// Descriptor set 1 shared by every frame: a small array of samplers and a variable sized array of sampled
+	// images indexed by the shaders. Both bindings are update-after-bind and partially bound, so a slot can be
+	// written while frames using the set are in flight as long as those frames do not read that slot.
+	class BindlessTable {
+	public:
+		static constexpr uint32_t SAMPLER_BINDING = 0;
+		static constexpr uint32_t TEXTURE_BINDING = 1; // variable count, must stay the last binding
+
+		static constexpr uint32_t MAX_SAMPLERS = 16;
+		// Upper bound on the texture array, drivers report limits in the millions
+		static constexpr uint32_t MAX_TEXTURES = 1u << 16;
+
+		explicit BindlessTable(Context& context);
+
+		BindlessTable(const BindlessTable&) = delete;
+		BindlessTable& operator=(const BindlessTable&) = delete;
+
+		[[nodiscard]] vk::DescriptorSetLayout layout() const { return *_layout; }
+		[[nodiscard]] vk::DescriptorSet set() const { return *_set; }
+		[[nodiscard]] uint32_t textureCapacity() const { return _textureCapacity; }
+
+		// Writes view to a free texture slot and returns it, recycled slots are reused first
+		uint32_t addTexture(vk::ImageView view);
+		// The caller guarantees no frame in flight still reads the slot
+		void removeTexture(uint32_t slot);
+
+		// Returns the slot of sampler, registering it on first use
+		uint32_t addSampler(vk::Sampler sampler);
+
+	private:
+		Context& _context;
+		uint32_t _textureCapacity = 0;
+		uint32_t _samplerCapacity = 0;
+
+		vk::raii::DescriptorSetLayout _layout = nullptr;
+		vk::raii::DescriptorPool _pool = nullptr;
+		vk::raii::DescriptorSet _set = nullptr;
+
+		// Guards the slot lists and the descriptor writes, the set is externally synchronized
+		std::mutex _mutex;
+		std::vector<uint32_t> _freeTextureSlots;
+		uint32_t _nextTextureSlot = 0;
+		std::vector<vk::Sampler> _samplers;
+	};
+}
@@ -5,6 +5,9 @@
 #pragma once
 
 #include <core/rendering/vulkan/header.hpp>
+#include <core/rendering/vulkan/MemoryAllocator.hpp>
+#include <core/rendering/vulkan/SamplerCache.hpp>
+#include <core/rendering/vulkan/Uploader.hpp>
 #include <core/window/Window.hpp>
 
 #include <core/rendering/IContext.hpp>
@@ -26,6 +29,7 @@ namespace Core::Rendering::Vulkan {
 	struct QueueFamilyIndices {
 		std::optional<uint32_t> graphicsFamily;
 		std::optional<uint32_t> presentFamily;
+		std::optional<uint32_t> transferFamily; // transfer capable family without graphics, if any
 
 		bool isComplete() const { return graphicsFamily.has_value() && presentFamily.has_value(); }
 	};
@@ -36,6 +40,8 @@ namespace Core::Rendering::Vulkan {
 		friend class TextureManager;
 		friend class PipelineManager;
 		friend class Renderer;
+		friend class Uploader;
+		friend class StagingRing;
 	public:
 		explicit Context() = default;
 		~Context() override = default;
@@ -49,16 +55,25 @@ namespace Core::Rendering::Vulkan {
 		void shutdown() override;
 		std::unique_ptr<IRenderer> createRenderer(Window &window) override;
 
+		[[nodiscard]] MemoryStats memoryStats() const { return _allocator->stats(); }
+		[[nodiscard]] SamplerCacheStats samplerStats() const { return _samplerCache->stats(); }
+
 	protected:
 		vk::raii::Instance &instance() {return _instance;}
 		vk::raii::PhysicalDevice& physicalDevice() {return _physicalDevice;}
 		vk::raii::Device& device() {return _device;}
 		vk::raii::Queue& graphicsQueue() {return _graphicsQueue;}
 		vk::raii::Queue& presentQueue() {return _presentQueue;}
+		vk::raii::Queue& transferQueue() {return _transferQueue;}
 		vk::raii::SurfaceKHR& surface() {return _surface;}
 		vk::raii::CommandPool& commandPool() {return _commandPool;}
+		MemoryAllocator& allocator() {return *_allocator;}
 		uint32_t graphicsQueueFamily() const {return _queueFamilyIndices.graphicsFamily.value();}
 		uint32_t presentQueueFamily() const {return _queueFamilyIndices.presentFamily.value();}
+		uint32_t transferQueueFamily() const {return _queueFamilyIndices.transferFamily.value_or(graphicsQueueFamily());}
+		Uploader& uploader() {return *_uploader;}
+		SamplerCache& samplers() {return *_samplerCache;}
+		bool supportsTextureCompressionBC() const {return _textureCompressionBC;}
 		void waitIdle();
 
 	private:
@@ -89,49 +104,38 @@ namespace Core::Rendering::Vulkan {
 
 		void createCommandPool();
 
+		void createAllocator();
+
+		void createUploader();
+
+		void createSamplerCache();
+
 		// helpers
-		uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
-		vk::raii::ImageView createImageView(vk::raii::Image &image, vk::Format format, vk::ImageAspectFlags aspectFlags) const;
-		vk::raii::ImageView createImageView(vk::Image &image, vk::Format format, vk::ImageAspectFlags aspectFlags) const;
+		vk::raii::ImageView createImageView(vk::raii::Image &image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels = 1) const;
+		vk::raii::ImageView createImageView(vk::Image &image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels = 1) const;
 		void createImage(uint32_t width, uint32_t height, vk::Format format, vk::ImageTiling tiling,
 						 vk::ImageUsageFlags usage,
 						 vk::MemoryPropertyFlags properties, vk::raii::Image &image,
-						 vk::raii::DeviceMemory &imageMemory);
+						 Allocation &imageMemory, uint32_t mipLevels = 1);
 
 		void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties,
-		                  vk::raii::Buffer &buffer, vk::raii::DeviceMemory &bufferMemory) const;
-
-		void copyBuffer(vk::raii::Buffer &srcBuffer, vk::raii::Buffer &dstBuffer, vk::DeviceSize size) const;
+		                  vk::raii::Buffer &buffer, Allocation &bufferMemory) const;
 
 		void createStagingBuffer(const void *data, vk::DeviceSize size,
-		                         vk::raii::Buffer &stagingBuffer, vk::raii::DeviceMemory &stagingMemory) const;
+		                         vk::raii::Buffer &stagingBuffer, Allocation &stagingMemory) const;
 
 		template<typename T>
-		void createDeviceLocalBuffer(const std::vector<T>& data,
+		UploadTicket createDeviceLocalBuffer(const std::vector<T>& data,
 							 vk::BufferUsageFlags usage,
 							 vk::raii::Buffer& buffer,
-							 vk::raii::DeviceMemory& memory) {
-			vk::raii::Buffer stagingBuffer({});
-			vk::raii::DeviceMemory stagingMemory({});
-
-			createStagingBuffer(data.data(), sizeof(T) * data.size(), stagingBuffer, stagingMemory);
+							 Allocation& memory) {
 			createBuffer(sizeof(T) * data.size(), usage | vk::BufferUsageFlagBits::eTransferDst,
 								  vk::MemoryPropertyFlagBits::eDeviceLocal, buffer, memory);
-			copyBuffer(stagingBuffer, buffer, sizeof(T) * data.size());
+			return _uploader->uploadBuffer(data.data(), sizeof(T) * data.size(), *buffer);
 		}
 
-		vk::raii::CommandBuffer beginSingleTimeCommands() const;
-
-		void endSingleTimeCommands(vk::raii::CommandBuffer &commandBuffer) const;
-
-		void transitionImageLayout(const vk::raii::Image &image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout);
-
-		void copyBufferToImage(const vk::raii::Buffer &buffer, vk::raii::Image &image, uint32_t width, uint32_t height);
-
-		void createTextureImageFromData(const void *pixels, uint32_t width, uint32_t height, vk::raii::Image &outImage,
-		                                vk::raii::DeviceMemory &outMemory);
-
-		vk::raii::Sampler createTextureSampler();
+		// Anisotropic repeat sampling, pass it to the sampler cache
+		[[nodiscard]] vk::SamplerCreateInfo textureSamplerInfo() const;
 
 		// Instance
 		vk::raii::Context _context;
@@ -145,13 +149,24 @@ namespace Core::Rendering::Vulkan {
 		// Queues
 		vk::raii::Queue _graphicsQueue = nullptr;
 		vk::raii::Queue _presentQueue = nullptr;
+		vk::raii::Queue _transferQueue = nullptr;
 		QueueFamilyIndices _queueFamilyIndices;
+		bool _textureCompressionBC = false;
 
 		// Surface
 		vk::raii::SurfaceKHR _surface = nullptr;
 
 		// Command Pool
 		vk::raii::CommandPool _commandPool = nullptr;
+
+		// Device memory, destroyed before the device
+		std::unique_ptr<MemoryAllocator> _allocator;
+
+		// Uploads, holds staging allocations so it is destroyed before the allocator
+		std::unique_ptr<Uploader> _uploader;
+
+		// Samplers shared by all textures, destroyed before the device
+		std::unique_ptr<SamplerCache> _samplerCache;
 	};
 
 
@@ -0,0 +1,75 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Core::Rendering::Vulkan {
+
+	// World space planes, xyz normal pointing inside and w distance
+	using FrustumPlanes = std::array<glm::vec4, 6>;
+
+	// Bounding spheres in structure-of-arrays layout so the culling kernels load a full register of each
+	// component at once. Arrays are padded to a multiple of LANES with spheres that never pass the test.
+	class SphereBounds {
+	public:
+		static constexpr size_t LANES = 8;
+
+		void clear();
+		void reserve(size_t count);
+		void push(const glm::vec3& center, float radius);
+
+		[[nodiscard]] size_t size() const { return _size; }
+		[[nodiscard]] size_t paddedSize() const { return _centerX.size(); }
+
+		[[nodiscard]] const float* centerX() const { return _centerX.data(); }
+		[[nodiscard]] const float* centerY() const { return _centerY.data(); }
+		[[nodiscard]] const float* centerZ() const { return _centerZ.data(); }
+		[[nodiscard]] const float* radius() const { return _radius.data(); }
+
+	private:
+		std::vector<float> _centerX;
+		std::vector<float> _centerY;
+		std::vector<float> _centerZ;
+		std::vector<float> _radius;
+		size_t _size = 0;
+	};
+
+	enum class CullingKernel {
+		Scalar,
+		SSE,  // 4 spheres per iteration
+		AVX2  // 8 spheres per iteration
+	};
+
+	// Widest kernel the running CPU supports, detected once
+	CullingKernel bestCullingKernel();
+	const char* cullingKernelName(CullingKernel kernel);
+
+	// Writes the indices of the spheres intersecting the frustum to visible in ascending order and returns
+	// how many there are. visible must have room for bounds.size() entries.
+	uint32_t cullSpheres(const SphereBounds& bounds, const FrustumPlanes& planes, uint32_t* visible,
+	                     CullingKernel kernel = bestCullingKernel());
+
+	// Single sphere test, the one the kernels run
+	bool isSphereVisible(const FrustumPlanes& planes, const glm::vec3& center, float radius);
+
+	// Axis scales further apart than this fraction of the largest one turn cone culling off, must match
+	// CONE_SCALE_TOLERANCE in shader.slang
+	constexpr float CONE_SCALE_TOLERANCE = 1e-3f;
+
+	// Matrix moving cone axes through transform, returns false when cones cannot be culled under it. Axes move
+	// like normals, by the cofactor matrix (the inverse transpose scaled by the determinant), which also follows
+	// the winding of mirrored transforms. Cone angles only survive rotations and uniform scales.
+	bool coneTransform(const glm::mat4& transform, glm::mat3& cofactor);
+
+	// True when every triangle bounded by the sphere and its normal cone (axis xyz, cutoff w) faces away
+	// from eye, see Core::Meshlet::cone. Cones with a cutoff of 1 are never back-facing.
+	bool isConeBackfacing(const glm::vec4& cone, const glm::vec3& center, float radius, const glm::vec3& eye);
+}
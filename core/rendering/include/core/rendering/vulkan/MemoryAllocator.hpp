@@ -0,0 +1,122 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <core/rendering/vulkan/header.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Core::Rendering::Vulkan {
+
+	class Allocation;
+
+	// Kind of resource bound to an allocation. Linear (buffers, linear images) and optimal (tiled images)
+	// resources are kept in separate blocks so neighbours never violate bufferImageGranularity.
+	enum class ResourceKind {
+		Linear,
+		Optimal
+	};
+
+	struct MemoryStats {
+		uint32_t blockCount = 0;
+		uint32_t dedicatedBlockCount = 0;
+		uint32_t allocationCount = 0;
+		vk::DeviceSize blockBytes = 0;
+		vk::DeviceSize usedBytes = 0;
+		vk::DeviceSize freeBytes = 0;
+		vk::DeviceSize largestFreeRange = 0;
+
+		// 0 when all free space is contiguous, close to 1 when it is scattered in small ranges
+		[[nodiscard]] float fragmentation() const {
+			return freeBytes == 0 ? 0.0f : 1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes);
+		}
+	};
+
+	class MemoryAllocator {
+		friend class Allocation;
+	public:
+		static constexpr vk::DeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+		MemoryAllocator(const vk::raii::PhysicalDevice& physicalDevice, const vk::raii::Device& device,
+		                vk::DeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+		~MemoryAllocator() = default;
+
+		MemoryAllocator(const MemoryAllocator&) = delete;
+		MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+		MemoryAllocator(MemoryAllocator&&) = delete;
+		MemoryAllocator& operator=(MemoryAllocator&&) = delete;
+
+		Allocation allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, ResourceKind kind);
+
+		[[nodiscard]] uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+
+		[[nodiscard]] MemoryStats stats() const;
+		[[nodiscard]] MemoryStats stats(uint32_t memoryTypeIndex) const;
+
+	private:
+		struct Block {
+			vk::raii::DeviceMemory memory = nullptr;
+			vk::DeviceSize size = 0;
+			void* mapped = nullptr;
+			bool dedicated = false;
+			uint32_t pool = 0;
+			uint32_t allocationCount = 0;
+			std::map<vk::DeviceSize, vk::DeviceSize> freeRanges; // offset -> size, coalesced
+		};
+
+		struct Pool {
+			std::vector<std::unique_ptr<Block>> blocks;
+		};
+
+		static uint32_t poolIndex(uint32_t memoryTypeIndex, ResourceKind kind) {
+			return memoryTypeIndex * 2 + (kind == ResourceKind::Linear ? 0 : 1);
+		}
+
+		Block& createBlock(uint32_t pool, vk::DeviceSize size, bool dedicated);
+		static bool tryAllocate(Block& block, vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& outOffset);
+		void free(Block* block, vk::DeviceSize offset, vk::DeviceSize size);
+		static void accumulate(const Block& block, MemoryStats& stats);
+
+		const vk::raii::Device& _device;
+		vk::PhysicalDeviceMemoryProperties _memoryProperties;
+		std::vector<vk::DeviceSize> _blockSizes; // preferred block size per memory heap
+		std::vector<Pool> _pools;
+
+		mutable std::mutex _mutex;
+	};
+
+	// Sub-range of a device memory block, returned to its block when destroyed.
+	class Allocation {
+		friend class MemoryAllocator;
+	public:
+		Allocation() = default;
+		Allocation(std::nullptr_t) {}
+		~Allocation();
+
+		Allocation(const Allocation&) = delete;
+		Allocation& operator=(const Allocation&) = delete;
+		Allocation(Allocation&& other) noexcept;
+		Allocation& operator=(Allocation&& other) noexcept;
+
+		[[nodiscard]] vk::DeviceMemory memory() const;
+		[[nodiscard]] vk::DeviceSize offset() const { return _offset; }
+		[[nodiscard]] vk::DeviceSize size() const { return _size; }
+		// Persistently mapped pointer to the start of the allocation, nullptr if the memory is not host visible
+		[[nodiscard]] void* mapped() const;
+
+		explicit operator bool() const { return _allocator != nullptr; }
+
+	private:
+		void release();
+
+		MemoryAllocator* _allocator = nullptr;
+		MemoryAllocator::Block* _block = nullptr;
+		vk::DeviceSize _offset = 0;
+		vk::DeviceSize _size = 0;
+	};
+}
@@ -7,25 +7,73 @@
 #include <core/rendering/vulkan/Context.hpp>
 #include <core/common/RenderTypes.hpp>
 
+#include <array>
+#include <span>
+
 namespace Core::Rendering::Vulkan {
 	class MeshManager {
 	public:
+		static constexpr vk::DeviceSize VERTEX_PAGE_SIZE = 64ull * 1024 * 1024;
+		static constexpr vk::DeviceSize INDEX_PAGE_SIZE = 32ull * 1024 * 1024;
+
 		explicit MeshManager(Context& context);
 
 		MeshID createMesh(const MeshData& meshData);
 
-		struct Mesh {
+		// Meshes are packed into a few large vertex/index buffers so many of them can be drawn
+		// by one indirect call. A new page is opened when the current ones are full.
+		struct GeometryPage {
 			vk::raii::Buffer vertexBuffer = nullptr;
-			vk::raii::DeviceMemory vertexMemory = nullptr;
+			Allocation vertexMemory = nullptr;
 			vk::raii::Buffer indexBuffer = nullptr;
-			vk::raii::DeviceMemory indexMemory = nullptr;
+			Allocation indexMemory = nullptr;
+			vk::DeviceSize vertexCapacity = 0;
+			vk::DeviceSize vertexUsed = 0;
+			vk::DeviceSize indexCapacity = 0;
+			vk::DeviceSize indexUsed = 0;
+		};
+
+		struct Mesh {
+			uint32_t page = 0;
+			int32_t vertexOffset = 0;
+			uint32_t firstIndex = 0; // in elements of indexType
 			uint32_t indexCount = 0;
+			IndexType indexType = IndexType::Uint32;
+			// Levels of detail as ranges of the page's index buffer, finest first. lods[0] is the range of
+			// firstIndex and indexCount.
+			uint32_t lodCount = 1;
+			std::array<MeshLod, MAX_MESH_LODS> lods{};
+			// Partition of lods[0] in meshlets(), their firstIndex is in the page's index buffer
+			uint32_t firstMeshlet = 0;
+			uint32_t meshletCount = 0;
+			// Local space bounds, computed once at creation
+			glm::vec3 boundsMin{0.0f};
+			glm::vec3 boundsMax{0.0f};
+			glm::vec4 boundingSphere{0.0f}; // center (xyz) and radius (w)
+			// Quantized positions decode as positionOffset + pos * positionScale
+			VertexFormat vertexFormat = VertexFormat::Full;
+			glm::vec3 positionOffset{0.0f};
+			glm::vec3 positionScale{1.0f};
+			UploadTicket ready = 0;
 		};
 
 		const Mesh& get(MeshID id) const {return _meshes.at(id);}
+		bool isReady(MeshID id) const {return _context.uploader().isComplete(_meshes.at(id).ready);}
+		std::span<const Meshlet> meshlets(const Mesh& mesh) const {
+			return std::span(_meshlets).subspan(mesh.firstMeshlet, mesh.meshletCount);
+		}
+
+		const GeometryPage& page(uint32_t index) const {return _pages.at(index);}
+		uint32_t pageCount() const {return static_cast<uint32_t>(_pages.size());}
 
 	private:
+		uint32_t findPage(vk::DeviceSize vertexBytes, vk::DeviceSize vertexStride, vk::DeviceSize indexBytes,
+		                  vk::DeviceSize indexStride);
+		void createPage(vk::DeviceSize vertexCapacity, vk::DeviceSize indexCapacity);
+
 		Context& _context;
+		std::vector<GeometryPage> _pages;
 		std::vector<Mesh> _meshes;
+		std::vector<Meshlet> _meshlets;
 	};
-}
\ No newline at end of file
+}
@@ -4,12 +4,16 @@
 #pragma once
 
 #include <core/rendering/vulkan/Swapchain.hpp>
+#include <core/common/RenderTypes.hpp>
+#include <core/utils/ThreadPool.hpp>
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace Core::Rendering::Vulkan {
 
-	constexpr uint32_t MAX_TEXTURES = 256;
-
 	struct PipelineConfig {
 		uint32_t depthTestEnable = vk::True;
 		uint32_t depthWriteEnable = vk::True;
@@ -21,18 +25,63 @@ namespace Core::Rendering::Vulkan {
 		vk::FrontFace frontFace = vk::FrontFace::eCounterClockwise;
 
 		vk::SampleCountFlagBits rasterizationSamples = vk::SampleCountFlagBits::e1;
+
+		// Selects the vertex entry point and input layout, see Vertex.hpp
+		VertexFormat vertexFormat = VertexFormat::Full;
+
+		bool operator==(const PipelineConfig&) const = default;
+	};
+
+	// Graphics shader and fixed function state of one pipeline variant
+	struct PipelineVariant {
+		std::string shader;
+		PipelineConfig config;
+	};
+
+	// Threads per workgroup of the culling compute passes, must match [numthreads] in shader.slang
+	constexpr uint32_t CULL_WORKGROUP_SIZE = 64;
+
+	// Push constants of the culling compute passes, must match CullConstants in shader.slang
+	struct CullConstants {
+		glm::vec4 frustumPlanes[6];
+		uint32_t instanceCount;
+		uint32_t batchCount;
+		uint32_t groupCount;
+		float lodScale;           // pixels covered by a unit length at unit distance
+		glm::vec4 cameraPosition; // xyz, w is the level of detail error allowed in pixels
 	};
 
 	class PipelineManager {
 	public:
-		PipelineManager(Context& ctx, Swapchain& sc);
+		static constexpr const char* DEFAULT_CACHE_PATH = "pipeline_cache.bin";
+
+		// textureSetLayout is the bindless texture set bound at index 1 next to the per-frame set
+		PipelineManager(Context& ctx, Swapchain& sc, vk::DescriptorSetLayout textureSetLayout,
+		                std::string cachePath = DEFAULT_CACHE_PATH);
+
+		// Writes the pipeline cache back to disk, called once at shutdown
+		void saveCache() const;
+
+		// Registers the vertMain/fragMain shader under name, its variants are built by prewarm or on first use
+		void registerShader(const std::string &name, const std::vector<char> &code);
 
+		// Registers the vertMain/fragMain shader under name and builds its variant for config right away
 		void createPipeline(const std::string &name, const std::vector<char> &code,
 		                    const PipelineConfig &config = PipelineConfig());
+		void createComputePipeline(const std::string &name, const std::vector<char> &code, const std::string &entryPoint);
 
 		vk::raii::PipelineLayout& pipelineLayout() { return _pipelineLayout; }
 		vk::raii::DescriptorSetLayout& descriptorSetLayout() { return _descriptorSetLayout; }
 
+		// Graphics pipeline of a registered shader for config and the current attachment formats, compiled on
+		// first use. Safe to call from several threads, each variant is compiled exactly once. A variant compiled
+		// here rather than by createPipeline or prewarm is logged, it stalled whichever frame needed it.
+		vk::Pipeline get(const std::string& shader, const PipelineConfig& config) { return getVariant(shader, config, true); }
+
+		// Compiles variants across the worker threads so the first frame using them does not stall
+		void prewarm(const std::vector<PipelineVariant>& variants, Utils::ThreadPool& threads);
+
+		// Compute pipeline by name
 		vk::raii::Pipeline& get(const std::string& name) {
 			auto it = _pipelines.find(name);
 			if (it == _pipelines.end()) {
@@ -43,17 +92,59 @@ namespace Core::Rendering::Vulkan {
 
 
 	private:
+		struct Shader {
+			vk::raii::ShaderModule module = nullptr;
+			uint64_t hash = 0;
+		};
+
+		// Identifies a graphics variant: shaders with identical code share their variants
+		struct VariantKey {
+			uint64_t shaderHash;
+			PipelineConfig config;
+			vk::Format colorFormat;
+			vk::Format depthFormat;
+
+			bool operator==(const VariantKey&) const = default;
+		};
+
+		struct VariantKeyHash {
+			size_t operator()(const VariantKey& key) const noexcept;
+		};
+
+		struct Variant {
+			std::once_flag built;
+			vk::raii::Pipeline pipeline = nullptr;
+		};
+
+		vk::Pipeline getVariant(const std::string& shader, const PipelineConfig& config, bool onFirstUse);
+
 		void createDescriptorSetLayout();
 		void createPipelineLayout();
+		void createPipelineCache();
+		[[nodiscard]] std::vector<char> readCacheFile() const;
+
+		vk::raii::Pipeline buildGraphicsPipeline(vk::ShaderModule shaderModule, const PipelineConfig& config,
+		                                         vk::Format colorFormat, vk::Format depthFormat) const;
 
 		Context& _context;
 		Swapchain& _swapchain;
 
+		// Shared by every pipeline creation, seeded from the previous run
+		std::string _cachePath;
+		vk::raii::PipelineCache _pipelineCache = nullptr;
+
 		vk::raii::DescriptorSetLayout _descriptorSetLayout = nullptr;
+		vk::DescriptorSetLayout _textureSetLayout;
 		vk::raii::PipelineLayout _pipelineLayout = nullptr;
 
 		std::unordered_map<std::string, vk::raii::Pipeline> _pipelines;
 
+		// Graphics shaders and their variants, guarded by _variantsMutex. Variants are heap allocated so
+		// their address stays valid while another thread compiles them outside the lock.
+		std::unordered_map<std::string, Shader> _shaders;
+		std::unordered_map<VariantKey, std::unique_ptr<Variant>, VariantKeyHash> _variants;
+		std::mutex _variantsMutex;
+
 		vk::raii::ShaderModule createShaderModule(vk::raii::Device& device, const std::vector<char>& code);
 	};
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <ranges>
 #include <vector>
@@ -11,22 +12,87 @@
 #include <core/rendering/vulkan/Swapchain.hpp>
 #include <core/rendering/IRenderer.hpp>
 
+#include <core/rendering/vulkan/BindlessTable.hpp>
+#include <core/rendering/vulkan/Culling.hpp>
 #include <core/rendering/vulkan/PipelineManager.hpp>
 #include <core/rendering/vulkan/MeshManager.hpp>
 #include <core/rendering/vulkan/TextureManager.hpp>
+#include <core/utils/ThreadPool.hpp>
 
 namespace Core::Rendering::Vulkan {
 
-	constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
-
 	class Renderer : public IRenderer {
 
 		struct UniformBufferObject {
-			glm::mat4 model;
 			glm::mat4 view;
 			glm::mat4 proj;
 		};
 
+		// Per-instance entry of the instance storage buffer, must match InstanceData in shader.slang
+		struct InstanceData {
+			glm::mat4 model;
+			uint32_t textureIndex; // bindless texture slot
+			uint32_t batchIndex;
+			uint32_t samplerIndex; // bindless sampler slot
+			uint32_t padding;
+		};
+
+		// Instances sharing a mesh, drawn by one indirect command per level of detail or visible meshlet whatever
+		// their textures
+		struct DrawBatch {
+			MeshID meshID;
+			uint32_t firstInstance;
+			uint32_t instanceCount;
+			uint32_t firstCullBatch; // entry of the finest level, the other levels then the meshlets follow
+		};
+
+		// Per-level or per-meshlet entry read by the culling passes and vertMainQuantized, must match CullBatch in
+		// shader.slang. firstInstance starts the entry's range of the visible instance list, sized for every instance
+		// of the batch.
+		struct CullBatch {
+			glm::vec4 boundingSphere;
+			uint32_t indexCount;
+			uint32_t firstIndex;
+			int32_t vertexOffset;
+			uint32_t firstInstance;
+			uint32_t group;
+			uint32_t groupFirstCommand;
+			float lodError;    // object space error of the level
+			uint32_t lodCount; // levels of the mesh, the same in each of its entries
+			glm::vec4 positionOffset; // quantized position decoding, w unused
+			glm::vec4 positionScale;
+			glm::vec4 cone;        // meshlet entries: normal cone axis (xyz) and cutoff (w)
+			uint32_t clusterCount; // finest level entry: meshlets following the levels, 0 draws the level whole
+			uint32_t padding[3];
+		};
+
+		// Up to maxDrawIndirectCount batches whose meshes live in the same geometry page and share a vertex format
+		// and an index type. Each group owns a range of the command buffer and one draw count written by the GPU.
+		struct DrawGroup {
+			uint32_t page;
+			VertexFormat vertexFormat;
+			IndexType indexType;
+			uint32_t firstCommand;
+			uint32_t commandCount;
+		};
+
+		// Buffer owned by one frame in flight, reallocated when it needs to grow
+		struct GrowableBuffer {
+			vk::raii::Buffer buffer = nullptr;
+			Allocation memory = nullptr;
+			vk::DeviceSize capacity = 0;
+		};
+
+		static constexpr uint32_t INITIAL_INSTANCE_CAPACITY = 1024;
+		// Instances use the coarsest level of detail whose error covers at most this many pixels
+		static constexpr float LOD_ERROR_PIXELS = 1.0f;
+		// Meshes with fewer meshlets are culled whole, their per-cluster commands would cost more than they skip
+		static constexpr uint32_t MIN_CULLED_CLUSTERS = 32;
+		// Every culled meshlet owns a visible range as large as its batch. Batches are culled per cluster while
+		// their meshlets times instances fit in this many slots in total (4 MiB per frame in flight), the
+		// remaining ones are culled per level.
+		static constexpr uint32_t MAX_CLUSTER_SLOTS = 1u << 20;
+
 	public:
 
 		Renderer(Context& context, Window& window);
@@ -41,35 +107,70 @@ namespace Core::Rendering::Vulkan {
 		void drawFrame() override;
 		void shutdown() override;
 
+		// Registers the shader and compiles a variant for every vertex format, which meshes pick only once loaded
+		// Registers the shader and compiles one variant per vertex format on the worker threads
 		void createPipeline(const std::string& name, const ShaderData& shaderData) override {
-			_pipelineManager->createPipeline(name, shaderData.code);
+			_pipelineManager->registerShader(name, shaderData.code);
+
+			std::vector<PipelineVariant> variants;
+			for (uint32_t format = 0; format < VERTEX_FORMAT_COUNT; format++)
+				variants.push_back({name, PipelineConfig{.vertexFormat = static_cast<VertexFormat>(format)}});
+			prewarmPipelines(variants);
+		}
+
+		void createComputePipeline(const std::string& name, const ShaderData& shaderData, const std::string& entryPoint) override {
+			_pipelineManager->createComputePipeline(name, shaderData.code, entryPoint);
+		}
+
+		// Compiles graphics pipeline variants on the worker threads ahead of their first use
+		void prewarmPipelines(const std::vector<PipelineVariant>& variants) {
+			_pipelineManager->prewarm(variants, *_workerThreads);
 		}
 
 		MeshID createMesh(const MeshData& meshData) override {
 			return _meshManager->createMesh(meshData);
 		}
 
+		// The bindless slot is written right away, frames in flight never read it
 		TextureID createTexture(const TextureData& textureData) override {
-			auto textureID = _textureManager->loadTexture(textureData);
-			updateTextureDescriptor(textureID);
-			return textureID;
+			return _textureManager->loadTexture(textureData);
+		}
+
+		void destroyTexture(TextureID texture) override {
+			_textureManager->destroyTexture(texture);
+			_instancesDirty = true;
 		}
 
 		void addInstance(MeshID mesh, TextureID texture) override {
-			_instances.push_back({mesh, texture});
+			addInstance(mesh, texture, glm::mat4(1.0f));
+		}
+
+		void addInstance(MeshID mesh, TextureID texture, const glm::mat4& transform) override {
+			_instances.push_back({mesh, texture, transform});
+			_instancesDirty = true;
 		}
 
 	private:
 		void createSyncObjects();
 		void createCommandBuffers();
 		void createUniformBuffers();
+		void createDrawBuffers();
 		void createDescriptorPool();
 		void createDescriptorSets();
 
-		void updateTextureDescriptor(uint32_t textureIndex);
 		void updateUniformBuffer(uint32_t frameIndex);
 
+		void buildDrawBatches();
+		void updateDrawBuffers(uint32_t frameIndex);
+		bool reserveBuffer(GrowableBuffer& growable, vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties);
+		void writeDrawDescriptors(uint32_t frameIndex);
+
 		void recordCommandBuffer(uint32_t imageIndex);
+		void recordCulling(const vk::raii::CommandBuffer& commandBuffer);
+		void cullOnCpu(uint32_t frameIndex);
+		[[nodiscard]] uint32_t selectLod(const CullBatch* levels, const glm::vec3& center, float radius, float scale) const;
+		void cullClustersOnCpu(uint32_t instance, const CullBatch* levels, uint32_t* visible, uint32_t* entryInstanceCounts) const;
+		void recordDraws(const vk::raii::CommandBuffer& commandBuffer) const;
 
 		void recordTransitionImageLayout(vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
 		                                 vk::AccessFlags2 srcAccessMask, vk::AccessFlags2 dstAccessMask,
@@ -77,16 +178,42 @@ namespace Core::Rendering::Vulkan {
 		                                 vk::ImageAspectFlags image_aspect_flags) const;
 
 		std::vector<ModelData> _instances;
+		bool _instancesDirty = false;
+
+		// Instances sorted by geometry page and batch, uploaded to each frame's buffers when they change
+		std::vector<InstanceData> _instanceData;
+		std::vector<DrawBatch> _drawBatches;
+		std::vector<CullBatch> _cullBatches;
+		std::vector<DrawGroup> _drawGroups;
+		uint32_t _visibleInstanceCapacity = 0; // one range per level and per culled meshlet of every batch
+		uint64_t _instanceVersion = 0;
+
+		// Planes and position of the current camera, and the scale projecting lengths to pixels
+		FrustumPlanes _frustumPlanes{};
+		glm::vec3 _cameraPosition{0.0f};
+		float _lodScale = 0.0f;
+
+		// CPU culling path, used on software devices where the compute passes are slow.
+		// World space spheres follow the sorted instance order.
+		bool _cpuCulling = false;
+		SphereBounds _instanceBounds;
+		std::vector<float> _instanceScales; // largest axis scale of each transform, for level of detail errors
+		std::vector<uint32_t> _visibleInstances;
+		std::vector<uint32_t> _groupDrawCounts;
+		std::vector<uint32_t> _entryInstanceCounts; // of the batch being culled
 
 		Context& _context;
 		Window& _window;
 
 		std::unique_ptr<Swapchain> _swapchain;
+		std::unique_ptr<BindlessTable> _bindlessTable;
 		std::unique_ptr<PipelineManager> _pipelineManager;
 		std::unique_ptr<MeshManager> _meshManager;
 		std::unique_ptr<TextureManager> _textureManager;
 
 		uint32_t _frameIndex = 0;
+		uint64_t _frameNumber = 0;
+		uint32_t _maxDrawIndirectCount = 1;
 		bool _shouldRecreateSwapChain = false;
 
 		// Synchronization objects
@@ -97,14 +224,25 @@ namespace Core::Rendering::Vulkan {
 		// Command Buffers
 		std::vector<vk::raii::CommandBuffer> _commandBuffers;
 
+		// Compiles pipeline variants off the render thread
+		std::unique_ptr<Utils::ThreadPool> _workerThreads;
+
 		// Descriptor Pool and Sets
 		vk::raii::DescriptorPool _descriptorPool = nullptr;
 		std::vector<vk::raii::DescriptorSet> _descriptorSets;
 
 		// Uniform Buffers
 		std::vector<vk::raii::Buffer> _uniformBuffers;
-		std::vector<vk::raii::DeviceMemory> _uniformBuffersMemory;
+		std::vector<Allocation> _uniformBuffersMemory;
 		std::vector<void*> _uniformBuffersMapped;
+
+		// Instances and batches written by the CPU, visible instances and indirect draws written by the culling passes
+		std::array<GrowableBuffer, MAX_FRAMES_IN_FLIGHT> _instanceBuffers;
+		std::array<GrowableBuffer, MAX_FRAMES_IN_FLIGHT> _cullBatchBuffers;
+		std::array<GrowableBuffer, MAX_FRAMES_IN_FLIGHT> _visibleInstanceBuffers;
+		std::array<GrowableBuffer, MAX_FRAMES_IN_FLIGHT> _drawCommandBuffers;
+		std::array<GrowableBuffer, MAX_FRAMES_IN_FLIGHT> _drawCountBuffers; // group draw counts, then batch instance counts
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> _drawBuffersVersion{};
 	};
 }
 
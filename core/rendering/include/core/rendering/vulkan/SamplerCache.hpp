@@ -0,0 +1,72 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <core/rendering/vulkan/header.hpp>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Core::Rendering::Vulkan {
+
+	struct SamplerCacheStats {
+		uint64_t hits = 0;
+		uint64_t misses = 0; // samplers created
+		size_t samplerCount = 0;
+	};
+
+	// Samplers deduplicated by the contents of their create info, so any number of textures sharing
+	// sampling state share one handle and stay far below maxSamplerAllocationCount
+	class SamplerCache {
+	public:
+		SamplerCache(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device);
+
+		SamplerCache(const SamplerCache&) = delete;
+		SamplerCache& operator=(const SamplerCache&) = delete;
+
+		// Sampler matching info, created on the first request. Extension chains are not part of the key
+		// and are rejected. Thread safe, the handle lives as long as the cache.
+		vk::Sampler get(const vk::SamplerCreateInfo& info);
+
+		[[nodiscard]] SamplerCacheStats stats() const;
+
+	private:
+		// Create info fields, floats compared by bit pattern so equal keys always hash the same
+		struct Key {
+			VkSamplerCreateFlags flags;
+			vk::Filter magFilter;
+			vk::Filter minFilter;
+			vk::SamplerMipmapMode mipmapMode;
+			vk::SamplerAddressMode addressModeU;
+			vk::SamplerAddressMode addressModeV;
+			vk::SamplerAddressMode addressModeW;
+			uint32_t mipLodBias;
+			vk::Bool32 anisotropyEnable;
+			uint32_t maxAnisotropy;
+			vk::Bool32 compareEnable;
+			vk::CompareOp compareOp;
+			uint32_t minLod;
+			uint32_t maxLod;
+			vk::BorderColor borderColor;
+			vk::Bool32 unnormalizedCoordinates;
+
+			bool operator==(const Key&) const = default;
+		};
+
+		struct KeyHash {
+			size_t operator()(const Key& key) const noexcept;
+		};
+
+		static Key makeKey(const vk::SamplerCreateInfo& info);
+
+		vk::raii::Device& _device;
+		uint32_t _maxSamplers;
+
+		mutable std::mutex _mutex;
+		std::unordered_map<Key, vk::raii::Sampler, KeyHash> _samplers;
+		uint64_t _hits = 0;
+		uint64_t _misses = 0;
+	};
+}
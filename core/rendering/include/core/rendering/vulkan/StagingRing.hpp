@@ -0,0 +1,53 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <core/rendering/vulkan/header.hpp>
+#include <core/rendering/vulkan/MemoryAllocator.hpp>
+
+#include <deque>
+#include <optional>
+
+namespace Core::Rendering::Vulkan {
+
+	class Context;
+
+	// Persistently mapped host visible buffer handing out staging sub-ranges in FIFO order.
+	// Ranges written for an upload batch are retired together once the batch's timeline value is reached.
+	class StagingRing {
+	public:
+		static constexpr vk::DeviceSize FRAME_SIZE = 16ull * 1024 * 1024;
+
+		explicit StagingRing(Context& context, vk::DeviceSize capacity = FRAME_SIZE * MAX_FRAMES_IN_FLIGHT);
+
+		// Offset of a free range of `size` bytes, nullopt when the ring is full
+		std::optional<vk::DeviceSize> allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+
+		// Mark everything allocated since the last call as owned by the batch completing at `timelineValue`
+		void close(uint64_t timelineValue);
+		// Release ranges of batches whose timeline value has been reached
+		void reclaim(uint64_t completedValue);
+
+		[[nodiscard]] vk::Buffer buffer() const { return *_buffer; }
+		[[nodiscard]] void* mapped(vk::DeviceSize offset) const { return static_cast<char*>(_memory.mapped()) + offset; }
+		[[nodiscard]] vk::DeviceSize capacity() const { return _capacity; }
+
+	private:
+		struct Fence {
+			vk::DeviceSize end;
+			uint64_t timelineValue;
+		};
+
+		vk::raii::Buffer _buffer = nullptr;
+		Allocation _memory = nullptr;
+		vk::DeviceSize _capacity;
+
+		vk::DeviceSize _head = 0;       // next write position
+		vk::DeviceSize _tail = 0;       // oldest byte still in use
+		bool _wrapped = false;          // head went past the end of the buffer while tail did not
+		bool _open = false;             // allocations not yet owned by a batch
+		std::deque<Fence> _fences;
+	};
+}
@@ -53,7 +53,7 @@ namespace Core::Rendering::Vulkan {
 		std::vector<vk::raii::ImageView> _imageViews;
 
 		vk::raii::Image _depthImage = nullptr;
-		vk::raii::DeviceMemory _depthMemory = nullptr;
+		Allocation _depthMemory = nullptr;
 		vk::raii::ImageView _depthView = nullptr;
 		vk::Format _depthFormat;
 	};
@@ -3,8 +3,10 @@
 //
 
 #pragma once
+#include <deque>
 #include <vector>
 
+#include <core/rendering/vulkan/BindlessTable.hpp>
 #include <core/rendering/vulkan/Context.hpp>
 #include <core/common/RenderTypes.hpp>
 
@@ -13,24 +15,51 @@ namespace Core::Rendering::Vulkan {
 
 		struct Texture {
 			vk::raii::Image image = nullptr;
-			vk::raii::DeviceMemory memory = nullptr;
+			Allocation memory = nullptr;
 			vk::raii::ImageView view = nullptr;
-			vk::raii::Sampler sampler = nullptr;
+			uint32_t samplerIndex = 0; // slot in the bindless sampler array
+			UploadTicket ready = 0;
+		};
+
+		// Destroyed texture kept alive until the frames that may still sample it have completed
+		struct RetiredTexture {
+			TextureID id;
+			Texture texture;
+			uint64_t frame;
 		};
 
 	public:
-		explicit TextureManager(Context& context);
+		TextureManager(Context& context, BindlessTable& bindlessTable);
 
+		// The returned id is the texture's slot in the bindless texture array
 		TextureID loadTexture(const TextureData& textureData);
+		void destroyTexture(TextureID id);
 
 		TextureID createDummyTexture();
 
+		// Called once the fence of the frame about to be recorded was waited on, releases the textures
+		// retired at least MAX_FRAMES_IN_FLIGHT frames ago and recycles their slots
+		void beginFrame(uint64_t frameNumber);
+
 		const Texture& get(TextureID id) const { return _textures.at(id); }
+		bool contains(TextureID id) const { return id < _textures.size() && *_textures[id].view != nullptr; }
+		bool isReady(TextureID id) const { return _context.uploader().isComplete(_textures.at(id).ready); }
 
 	private:
+		// Allocates the full mip chain unless textureData brings its own or is block compressed, generating
+		// missing levels on the GPU or on the CPU when the format cannot be blitted with linear filtering
+		UploadTicket createImage(const TextureData& textureData, Texture& texture, uint32_t& mipLevels);
+		TextureID addTexture(Texture&& texture);
+		// Bindless slot of the cached sampler matching info
+		uint32_t samplerIndex(const vk::SamplerCreateInfo& info);
 
 		Context& _context;
-		std::vector<Texture> _textures;
+		BindlessTable& _bindlessTable;
+		bool _linearBlit = false;
 
+		// Indexed by bindless slot, empty entries are free slots
+		std::vector<Texture> _textures;
+		std::deque<RetiredTexture> _retired;
+		uint64_t _frameNumber = 0;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,107 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <core/rendering/vulkan/header.hpp>
+#include <core/rendering/vulkan/MemoryAllocator.hpp>
+#include <core/rendering/vulkan/StagingRing.hpp>
+
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Core::Rendering::Vulkan {
+
+	class Context;
+
+	// Timeline value a resource upload completes at. 0 means the resource is already usable.
+	using UploadTicket = uint64_t;
+
+	// Batches buffer and image uploads into a single command buffer per flush and submits them on the
+	// transfer queue. When that queue belongs to a dedicated family, ownership of every destination is
+	// released there and acquired on the graphics queue, so later graphics submissions see the data
+	// through queue submission order without any host-side wait.
+	class Uploader {
+	public:
+		explicit Uploader(Context& context);
+		~Uploader();
+
+		Uploader(const Uploader&) = delete;
+		Uploader& operator=(const Uploader&) = delete;
+		Uploader(Uploader&&) = delete;
+		Uploader& operator=(Uploader&&) = delete;
+
+		UploadTicket uploadBuffer(const void* data, vk::DeviceSize size, vk::Buffer dstBuffer, vk::DeviceSize dstOffset = 0);
+		// One mip level of the data passed to uploadImage
+		struct ImageLevel {
+			vk::DeviceSize offset;
+			uint32_t width;
+			uint32_t height;
+		};
+
+		UploadTicket uploadImage(const void* data, vk::DeviceSize size, vk::Image dstImage, uint32_t width, uint32_t height);
+		// Copies levels to the first mip levels of dstImage, then fills the remaining ones up to mipLevels by
+		// successive linear blits from the last copied level. The format must support linear filtered blits
+		// when levels does not cover every mip level.
+		UploadTicket uploadImage(const void* data, vk::DeviceSize size, vk::Image dstImage,
+		                         std::span<const ImageLevel> levels, uint32_t mipLevels);
+
+		// Submit everything recorded since the last flush. Must be called before the graphics work using it is submitted.
+		void flush();
+
+		[[nodiscard]] bool isComplete(UploadTicket ticket) const;
+		void wait(UploadTicket ticket) const;
+
+	private:
+		// Mip levels generated by blits, levels before sourceLevel were copied and wait in transfer layout
+		struct MipChain {
+			vk::Image image;
+			uint32_t sourceLevel;
+			uint32_t sourceWidth;
+			uint32_t sourceHeight;
+			uint32_t mipLevels;
+		};
+
+		struct Batch {
+			vk::raii::CommandBuffer transferCommands = nullptr;
+			vk::raii::CommandBuffer graphicsCommands = nullptr;
+			std::vector<vk::raii::Buffer> stagingBuffers; // overflow when the staging ring is full
+			std::vector<Allocation> stagingMemory;
+			std::vector<vk::BufferMemoryBarrier2> bufferReleases;
+			std::vector<vk::ImageMemoryBarrier2> imageReleases;
+			std::vector<vk::BufferMemoryBarrier2> bufferAcquires; // only used with a dedicated transfer family
+			std::vector<vk::ImageMemoryBarrier2> imageAcquires;
+			std::vector<MipChain> mipChains; // generated on the graphics queue after the acquires
+			UploadTicket ticket = 0;
+		};
+
+		struct StagingRange {
+			vk::Buffer buffer;
+			vk::DeviceSize offset;
+		};
+
+		Batch& currentBatch();
+		StagingRange stage(Batch& batch, const void* data, vk::DeviceSize size);
+		void collect();
+
+		// Blits every level from the source one and leaves the whole image shader readable
+		static void recordMipChain(const vk::raii::CommandBuffer& commands, const MipChain& chain);
+
+		Context& _context;
+		bool _dedicatedTransfer = false;
+
+		vk::raii::CommandPool _transferPool = nullptr;
+		vk::raii::CommandPool _graphicsPool = nullptr;
+		vk::raii::Semaphore _timeline = nullptr;
+		uint64_t _timelineValue = 0;
+
+		StagingRing _stagingRing;
+		vk::DeviceSize _stagingAlignment = 16;
+
+		std::optional<Batch> _recording;
+		std::deque<Batch> _inFlight;
+	};
+}
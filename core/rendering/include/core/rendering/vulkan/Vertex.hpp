@@ -7,6 +7,8 @@
 #include <core/rendering/vulkan/header.hpp>
 #include <core/common/RenderTypes.hpp>
 
+#include <vector>
+
 namespace Core::Rendering::Vulkan {
 
 	struct Vertex : Core::Vertex {
@@ -24,4 +26,52 @@ namespace Core::Rendering::Vulkan {
 		}
 	};
 
-}
\ No newline at end of file
+	// Fetched by vertMainQuantized: the fixed function unit expands snorm/unorm/half to floats
+	struct QuantizedVertex : Core::QuantizedVertex {
+		static vk::VertexInputBindingDescription getBindingDescription() {
+			return {0, sizeof(QuantizedVertex), vk::VertexInputRate::eVertex};
+		}
+
+		static std::array<vk::VertexInputAttributeDescription, 3> getAttributeDescriptions(VertexFormat format) {
+			const vk::Format texCoordFormat = format == VertexFormat::QuantizedHalfUv
+				                                  ? vk::Format::eR16G16Sfloat
+				                                  : vk::Format::eR16G16Unorm;
+			return {
+				vk::VertexInputAttributeDescription(0, 0, vk::Format::eR16G16B16A16Snorm, offsetof(QuantizedVertex, pos)),
+				vk::VertexInputAttributeDescription(1, 0, vk::Format::eR16G16Snorm, offsetof(QuantizedVertex, normal)),
+				vk::VertexInputAttributeDescription(2, 0, texCoordFormat, offsetof(QuantizedVertex, texCoord))
+			};
+		}
+	};
+
+	constexpr vk::DeviceSize vertexStride(VertexFormat format) {
+		return format == VertexFormat::Full ? sizeof(Core::Vertex) : sizeof(Core::QuantizedVertex);
+	}
+
+	constexpr const char* vertexEntryPoint(VertexFormat format) {
+		return format == VertexFormat::Full ? "vertMain" : "vertMainQuantized";
+	}
+
+	constexpr vk::DeviceSize indexSize(IndexType type) {
+		return type == IndexType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+	}
+
+	constexpr vk::IndexType toVkIndexType(IndexType type) {
+		return type == IndexType::Uint16 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+	}
+
+	struct VertexInput {
+		vk::VertexInputBindingDescription binding;
+		std::vector<vk::VertexInputAttributeDescription> attributes;
+	};
+
+	inline VertexInput getVertexInput(VertexFormat format) {
+		if (format == VertexFormat::Full) {
+			const auto attributes = Vertex::getAttributeDescriptions();
+			return {Vertex::getBindingDescription(), {attributes.begin(), attributes.end()}};
+		}
+		const auto attributes = QuantizedVertex::getAttributeDescriptions(format);
+		return {QuantizedVertex::getBindingDescription(), {attributes.begin(), attributes.end()}};
+	}
+
+}
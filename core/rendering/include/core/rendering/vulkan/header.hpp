@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #if defined(__INTELLISENSE__) || !defined(USE_CPP20_MODULES)
 #include <vulkan/vulkan_raii.hpp>
 #else
@@ -11,6 +13,8 @@ import vulkan_hpp;
 #endif
 
 namespace Core::Rendering::Vulkan {
+	constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
 #ifdef NDEBUG
 	constexpr bool enableValidationLayers = false;
 #else
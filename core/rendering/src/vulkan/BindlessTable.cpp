@@ -0,0 +1,138 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/rendering/vulkan/BindlessTable.hpp>
+#include <core/rendering/vulkan/Context.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+namespace Core::Rendering::Vulkan {
+
+	BindlessTable::BindlessTable(Context &context)
+		: _context(context) {
+		auto &device = _context.device();
+
+		const auto properties = _context.physicalDevice().getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+		const auto &indexing = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+		_samplerCapacity = std::min({MAX_SAMPLERS,
+			indexing.maxPerStageDescriptorUpdateAfterBindSamplers,
+			indexing.maxDescriptorSetUpdateAfterBindSamplers});
+		_textureCapacity = std::min({MAX_TEXTURES,
+			indexing.maxPerStageDescriptorUpdateAfterBindSampledImages,
+			indexing.maxDescriptorSetUpdateAfterBindSampledImages,
+			indexing.maxPerStageUpdateAfterBindResources - _samplerCapacity});
+
+		std::cout << "[ASTRO CORE] [VULKAN] [BINDLESS] " << _textureCapacity << " texture slots, "
+				<< _samplerCapacity << " sampler slots" << std::endl;
+
+		const std::array bindings = {
+			vk::DescriptorSetLayoutBinding(SAMPLER_BINDING, vk::DescriptorType::eSampler, _samplerCapacity, vk::ShaderStageFlagBits::eFragment, nullptr),
+			vk::DescriptorSetLayoutBinding(TEXTURE_BINDING, vk::DescriptorType::eSampledImage, _textureCapacity, vk::ShaderStageFlagBits::eFragment, nullptr)
+		};
+
+		// Slots the shaders never index may stay unwritten, and written slots may change while the set is in use
+		constexpr vk::DescriptorBindingFlags commonFlags = vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+		                                                   vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending |
+		                                                   vk::DescriptorBindingFlagBits::ePartiallyBound;
+		const std::array<vk::DescriptorBindingFlags, 2> bindingFlags = {
+			commonFlags,
+			commonFlags | vk::DescriptorBindingFlagBits::eVariableDescriptorCount
+		};
+
+		vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{
+			.bindingCount = bindingFlags.size(),
+			.pBindingFlags = bindingFlags.data()
+		};
+		_layout = vk::raii::DescriptorSetLayout(device, vk::DescriptorSetLayoutCreateInfo{
+			.pNext = &bindingFlagsInfo,
+			.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+			.bindingCount = bindings.size(),
+			.pBindings = bindings.data()
+		});
+
+		const std::array poolSizes = {
+			vk::DescriptorPoolSize(vk::DescriptorType::eSampler, _samplerCapacity),
+			vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, _textureCapacity)
+		};
+		_pool = vk::raii::DescriptorPool(device, vk::DescriptorPoolCreateInfo{
+			.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind | vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+			.maxSets = 1,
+			.poolSizeCount = poolSizes.size(),
+			.pPoolSizes = poolSizes.data()
+		});
+
+		// A single set lives for the whole run, the texture array is allocated at the capacity
+		vk::DescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{
+			.descriptorSetCount = 1,
+			.pDescriptorCounts = &_textureCapacity
+		};
+		const vk::DescriptorSetLayout layout = *_layout;
+		_set = std::move(vk::raii::DescriptorSets(device, vk::DescriptorSetAllocateInfo{
+			.pNext = &variableCountInfo,
+			.descriptorPool = _pool,
+			.descriptorSetCount = 1,
+			.pSetLayouts = &layout
+		}).front());
+	}
+
+	uint32_t BindlessTable::addTexture(vk::ImageView view) {
+		std::scoped_lock lock(_mutex);
+
+		uint32_t slot;
+		if (!_freeTextureSlots.empty()) {
+			slot = _freeTextureSlots.back();
+			_freeTextureSlots.pop_back();
+		} else if (_nextTextureSlot < _textureCapacity) {
+			slot = _nextTextureSlot++;
+		} else {
+			throw std::runtime_error("bindless texture table is full");
+		}
+
+		vk::DescriptorImageInfo imageInfo{.imageView = view, .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal};
+		_context.device().updateDescriptorSets(vk::WriteDescriptorSet{
+			.dstSet = _set,
+			.dstBinding = TEXTURE_BINDING,
+			.dstArrayElement = slot,
+			.descriptorCount = 1,
+			.descriptorType = vk::DescriptorType::eSampledImage,
+			.pImageInfo = &imageInfo
+		}, {});
+
+		return slot;
+	}
+
+	void BindlessTable::removeTexture(uint32_t slot) {
+		// The descriptor is left as is: the slot is partially bound and nothing indexes it until it is reused
+		std::scoped_lock lock(_mutex);
+		_freeTextureSlots.push_back(slot);
+	}
+
+	uint32_t BindlessTable::addSampler(vk::Sampler sampler) {
+		std::scoped_lock lock(_mutex);
+
+		const auto it = std::ranges::find(_samplers, sampler);
+		if (it != _samplers.end())
+			return static_cast<uint32_t>(it - _samplers.begin());
+
+		if (_samplers.size() == _samplerCapacity)
+			throw std::runtime_error("bindless sampler table is full");
+
+		const auto slot = static_cast<uint32_t>(_samplers.size());
+		vk::DescriptorImageInfo samplerInfo{.sampler = sampler};
+		_context.device().updateDescriptorSets(vk::WriteDescriptorSet{
+			.dstSet = _set,
+			.dstBinding = SAMPLER_BINDING,
+			.dstArrayElement = slot,
+			.descriptorCount = 1,
+			.descriptorType = vk::DescriptorType::eSampler,
+			.pImageInfo = &samplerInfo
+		}, {});
+
+		_samplers.push_back(sampler);
+		return slot;
+	}
+}
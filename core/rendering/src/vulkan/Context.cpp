@@ -18,6 +18,21 @@ namespace Core::Rendering::Vulkan {
 	void Context::shutdown() {
 		if (*_device)
 			_device.waitIdle();
+
+		if (_allocator) {
+			const MemoryStats stats = _allocator->stats();
+			std::cout << "[ASTRO CORE] [VULKAN] [MEMORY] blocks: " << stats.blockCount
+					<< " (dedicated " << stats.dedicatedBlockCount << ")"
+					<< " allocations: " << stats.allocationCount
+					<< " used: " << stats.usedBytes << "/" << stats.blockBytes << " bytes"
+					<< " fragmentation: " << stats.fragmentation() << std::endl;
+		}
+
+		if (_samplerCache) {
+			const SamplerCacheStats stats = _samplerCache->stats();
+			std::cout << "[ASTRO CORE] [VULKAN] [SAMPLER] samplers: " << stats.samplerCount
+					<< " hits: " << stats.hits << " misses: " << stats.misses << std::endl;
+		}
 	}
 
 	std::unique_ptr<IRenderer> Context::createRenderer(Window &window) {
@@ -32,73 +47,56 @@ namespace Core::Rendering::Vulkan {
 		createSurface(window);
 		pickPhysicalDevice();
 		createLogicalDevice();
+		createAllocator();
 		createCommandPool();
+		createUploader();
+		createSamplerCache();
 	}
 
 	void Context::waitIdle() {
 		_device.waitIdle();
 	}
 
-	uint32_t Context::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const {
-		const vk::PhysicalDeviceMemoryProperties memProperties = _physicalDevice.getMemoryProperties();
-
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
-			if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-				return i;
-
-		throw std::runtime_error("failed to find suitable memory type!");
-	}
-
-	vk::raii::ImageView Context::createImageView(vk::raii::Image& image, vk::Format format, vk::ImageAspectFlags aspectFlags) const {
+	vk::raii::ImageView Context::createImageView(vk::raii::Image& image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels) const {
 		vk::ImageViewCreateInfo viewInfo{
 			.image = image,
 			.viewType = vk::ImageViewType::e2D,
 			.format = format,
-			.subresourceRange = {aspectFlags, 0, 1, 0, 1}
+			.subresourceRange = {aspectFlags, 0, mipLevels, 0, 1}
 		};
 		return vk::raii::ImageView(_device, viewInfo);
 	}
-	vk::raii::ImageView Context::createImageView(vk::Image& image, vk::Format format, vk::ImageAspectFlags aspectFlags) const {
+	vk::raii::ImageView Context::createImageView(vk::Image& image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels) const {
 		vk::ImageViewCreateInfo viewInfo{
 			.image = image,
 			.viewType = vk::ImageViewType::e2D,
 			.format = format,
-			.subresourceRange = {aspectFlags, 0, 1, 0, 1}
+			.subresourceRange = {aspectFlags, 0, mipLevels, 0, 1}
 		};
 		return vk::raii::ImageView(_device, viewInfo);
 	}
 
 	void Context::createImage(uint32_t width, uint32_t height, vk::Format format, vk::ImageTiling tiling,
 		vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image &image,
-		vk::raii::DeviceMemory &imageMemory)
+		Allocation &imageMemory, uint32_t mipLevels)
 	{
-		vk::ImageCreateInfo imageInfo{.imageType = vk::ImageType::e2D, .format = format, .extent = {width, height, 1}, .mipLevels = 1, .arrayLayers = 1, .samples = vk::SampleCountFlagBits::e1, .tiling = tiling, .usage = usage, .sharingMode = vk::SharingMode::eExclusive};
+		vk::ImageCreateInfo imageInfo{.imageType = vk::ImageType::e2D, .format = format, .extent = {width, height, 1}, .mipLevels = mipLevels, .arrayLayers = 1, .samples = vk::SampleCountFlagBits::e1, .tiling = tiling, .usage = usage, .sharingMode = vk::SharingMode::eExclusive};
 
 		image = vk::raii::Image(_device, imageInfo);
 
-		vk::MemoryRequirements memRequirements = image.getMemoryRequirements();
-		vk::MemoryAllocateInfo allocInfo{.allocationSize  = memRequirements.size,
-										 .memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties)};
-		imageMemory = vk::raii::DeviceMemory(_device, allocInfo);
-		image.bindMemory(imageMemory, 0);
+		const ResourceKind kind = tiling == vk::ImageTiling::eOptimal ? ResourceKind::Optimal : ResourceKind::Linear;
+		imageMemory = _allocator->allocate(image.getMemoryRequirements(), properties, kind);
+		image.bindMemory(imageMemory.memory(), imageMemory.offset());
 	}
 
-	void Context::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Buffer& buffer, vk::raii::DeviceMemory& bufferMemory) const {
+	void Context::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Buffer& buffer, Allocation& bufferMemory) const {
 		vk::BufferCreateInfo bufferInfo{ .size = size, .usage = usage, .sharingMode = vk::SharingMode::eExclusive };
 		buffer = vk::raii::Buffer(_device, bufferInfo);
-		vk::MemoryRequirements memRequirements = buffer.getMemoryRequirements();
-		vk::MemoryAllocateInfo allocInfo{ .allocationSize = memRequirements.size, .memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties) };
-		bufferMemory = vk::raii::DeviceMemory(_device, allocInfo);
-		buffer.bindMemory(*bufferMemory, 0);
-	}
-
-	void Context::copyBuffer(vk::raii::Buffer &srcBuffer, vk::raii::Buffer &dstBuffer, vk::DeviceSize size) const {
-		vk::raii::CommandBuffer commandCopyBuffer = beginSingleTimeCommands();
-		commandCopyBuffer.copyBuffer(srcBuffer, dstBuffer, vk::BufferCopy(0, 0, size));
-		endSingleTimeCommands(commandCopyBuffer);
+		bufferMemory = _allocator->allocate(buffer.getMemoryRequirements(), properties, ResourceKind::Linear);
+		buffer.bindMemory(bufferMemory.memory(), bufferMemory.offset());
 	}
 
-	void Context::createStagingBuffer(const void* data, vk::DeviceSize size, vk::raii::Buffer& stagingBuffer, vk::raii::DeviceMemory& stagingMemory) const {
+	void Context::createStagingBuffer(const void* data, vk::DeviceSize size, vk::raii::Buffer& stagingBuffer, Allocation& stagingMemory) const {
 		createBuffer(
 			size,
 			vk::BufferUsageFlagBits::eTransferSrc,
@@ -107,95 +105,10 @@ namespace Core::Rendering::Vulkan {
 			stagingMemory
 		);
 
-		void* mapped = stagingMemory.mapMemory(0, size);
-		memcpy(mapped, data, static_cast<size_t>(size));
-		stagingMemory.unmapMemory();
-	}
-
-	vk::raii::CommandBuffer Context::beginSingleTimeCommands() const {
-		vk::CommandBufferAllocateInfo allocInfo{ .commandPool = _commandPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1 };
-		vk::raii::CommandBuffer commandBuffer = std::move(_device.allocateCommandBuffers(allocInfo).front());
-		vk::CommandBufferBeginInfo beginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit };
-		commandBuffer.begin(beginInfo);
-		return commandBuffer;
+		memcpy(stagingMemory.mapped(), data, static_cast<size_t>(size));
 	}
 
-	void Context::endSingleTimeCommands(vk::raii::CommandBuffer& commandBuffer) const {
-		commandBuffer.end();
-		vk::SubmitInfo submitInfo{ .commandBufferCount = 1, .pCommandBuffers = &*commandBuffer };
-		_graphicsQueue.submit(submitInfo, nullptr);
-		_graphicsQueue.waitIdle();
-	}
-
-	void Context::transitionImageLayout(const vk::raii::Image &image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout)
-	{
-		auto commandBuffer = beginSingleTimeCommands();
-
-		vk::ImageMemoryBarrier barrier{.oldLayout = oldLayout, .newLayout = newLayout, .image = image, .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}};
-
-		vk::PipelineStageFlags sourceStage;
-		vk::PipelineStageFlags destinationStage;
-
-		if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eTransferDstOptimal)
-		{
-			barrier.srcAccessMask = {};
-			barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-
-			sourceStage      = vk::PipelineStageFlagBits::eTopOfPipe;
-			destinationStage = vk::PipelineStageFlagBits::eTransfer;
-		}
-		else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal)
-		{
-			barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-			barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-			sourceStage      = vk::PipelineStageFlagBits::eTransfer;
-			destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
-		}
-		else
-		{
-			throw std::invalid_argument("unsupported layout transition!");
-		}
-		commandBuffer.pipelineBarrier(sourceStage, destinationStage, {}, {}, nullptr, barrier);
-		endSingleTimeCommands(commandBuffer);
-	}
-
-	void Context::copyBufferToImage(const vk::raii::Buffer &buffer, vk::raii::Image &image, uint32_t width, uint32_t height)
-	{
-		vk::raii::CommandBuffer commandBuffer = beginSingleTimeCommands();
-		vk::BufferImageCopy                      region{.bufferOffset = 0, .bufferRowLength = 0, .bufferImageHeight = 0, .imageSubresource = {vk::ImageAspectFlagBits::eColor, 0, 0, 1}, .imageOffset = {0, 0, 0}, .imageExtent = {width, height, 1}};
-		commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, {region});
-		endSingleTimeCommands(commandBuffer);
-	}
-
-	void Context::createTextureImageFromData(const void* pixels,uint32_t width,uint32_t height,vk::raii::Image& outImage,vk::raii::DeviceMemory& outMemory)
-	{
-		vk::DeviceSize imageSize = width * height * 4; // assuming RGBA
-
-		// Staging buffer
-		vk::raii::Buffer stagingBuffer(nullptr);
-		vk::raii::DeviceMemory stagingMemory(nullptr);
-		createStagingBuffer(pixels, imageSize, stagingBuffer, stagingMemory);
-
-		// Device-local image
-		createImage(
-			width,
-			height,
-			vk::Format::eR8G8B8A8Srgb,
-			vk::ImageTiling::eOptimal,
-			vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
-			vk::MemoryPropertyFlagBits::eDeviceLocal,
-			outImage,
-			outMemory
-		);
-
-		// Copy from staging buffer
-		transitionImageLayout(outImage, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-		copyBufferToImage(stagingBuffer, outImage, width, height);
-		transitionImageLayout(outImage, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
-	}
-
-	vk::raii::Sampler Context::createTextureSampler() {
+	vk::SamplerCreateInfo Context::textureSamplerInfo() const {
 		vk::PhysicalDeviceProperties properties = _physicalDevice.getProperties();
 		vk::SamplerCreateInfo        samplerInfo{
 			.magFilter        = vk::Filter::eLinear,
@@ -208,9 +121,11 @@ namespace Core::Rendering::Vulkan {
 			.anisotropyEnable = vk::True,
 			.maxAnisotropy    = properties.limits.maxSamplerAnisotropy,
 			.compareEnable    = vk::False,
-			.compareOp        = vk::CompareOp::eAlways};
+			.compareOp        = vk::CompareOp::eAlways,
+			.minLod           = 0.0f,
+			.maxLod           = vk::LodClampNone};
 
-		return vk::raii::Sampler(_device, samplerInfo);
+		return samplerInfo;
 	}
 
 
@@ -386,13 +301,25 @@ namespace Core::Rendering::Vulkan {
 
 					auto features = device.template getFeatures2<vk::PhysicalDeviceFeatures2,
 													  vk::PhysicalDeviceVulkan11Features,
+													  vk::PhysicalDeviceVulkan12Features,
 													  vk::PhysicalDeviceVulkan13Features,
 													  vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
 
 					bool supportsRequiredFeatures = features.template get<vk::PhysicalDeviceVulkan11Features>().shaderDrawParameters &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().descriptorIndexing &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().shaderSampledImageArrayNonUniformIndexing &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingSampledImageUpdateAfterBind &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingUpdateUnusedWhilePending &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingPartiallyBound &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingVariableDescriptorCount &&
+													features.template get<vk::PhysicalDeviceVulkan12Features>().runtimeDescriptorArray &&
 													features.template get<vk::PhysicalDeviceVulkan13Features>().synchronization2 &&
 													features.template get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering &&
 													features.template get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState &&
+													features.template get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect &&
+													features.template get<vk::PhysicalDeviceFeatures2>().features.drawIndirectFirstInstance &&
 													features.template get<vk::PhysicalDeviceFeatures2>().features.samplerAnisotropy;
 
 					isSuitable = isSuitable && found && supportsRequiredFeatures;
@@ -422,12 +349,24 @@ namespace Core::Rendering::Vulkan {
 		if (!indices.isComplete())
 			throw std::runtime_error("failed to find required queue families!");
 
+		// Prefer a transfer-only family (DMA engine), then any non graphics family with transfer support
+		for (uint32_t i = 0; i < queueFamilyProperties.size(); ++i) {
+			const auto flags = queueFamilyProperties[i].queueFlags;
+			if (!(flags & vk::QueueFlagBits::eTransfer) || (flags & vk::QueueFlagBits::eGraphics))
+				continue;
+			if (!indices.transferFamily.has_value() || !(flags & vk::QueueFlagBits::eCompute))
+				indices.transferFamily = i;
+		}
+
 		std::cout << "[ASTRO CORE] [VULKAN] [CHECK] graphics family : " <<
 				(indices.graphicsFamily.has_value() ? std::to_string(indices.graphicsFamily.value()) : "NOT FOUND")
 				<< std::endl;
 		std::cout << "[ASTRO CORE] [VULKAN] [CHECK] present family  : " <<
 				(indices.presentFamily.has_value() ? std::to_string(indices.presentFamily.value()) : "NOT FOUND")
 				<< std::endl;
+		std::cout << "[ASTRO CORE] [VULKAN] [CHECK] transfer family : " <<
+				(indices.transferFamily.has_value() ? std::to_string(indices.transferFamily.value()) : "SHARED WITH GRAPHICS")
+				<< std::endl;
 
 		return indices;
 	}
@@ -438,7 +377,8 @@ namespace Core::Rendering::Vulkan {
 
 		std::set<uint32_t> uniqueFamilies = {
 			_queueFamilyIndices.graphicsFamily.value(),
-			_queueFamilyIndices.presentFamily.value()
+			_queueFamilyIndices.presentFamily.value(),
+			transferQueueFamily()
 		};
 
 		std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
@@ -454,14 +394,23 @@ namespace Core::Rendering::Vulkan {
 		// TO COMPLETE FURTHER
 		vk::PhysicalDeviceFeatures deviceFeatures;
 
+		// Optional: without it block compressed textures are rejected at load
+		_textureCompressionBC = _physicalDevice.getFeatures().textureCompressionBC;
+
 		// Create a chain of feature structures
-		// Feature chain (Vulkan 1.1, 1.3 + extended dynamic state)
+		// Feature chain (Vulkan 1.1, 1.2, 1.3 + extended dynamic state)
 		vk::StructureChain<vk::PhysicalDeviceFeatures2,
 							vk::PhysicalDeviceVulkan11Features,
+							vk::PhysicalDeviceVulkan12Features,
 							vk::PhysicalDeviceVulkan13Features,
 							vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain = {
-			{.features = {.samplerAnisotropy = true } }, // vk::PhysicalDeviceFeatures2
+			{.features = {.multiDrawIndirect = true, .drawIndirectFirstInstance = true, .samplerAnisotropy = true,
+			              .textureCompressionBC = _textureCompressionBC } }, // vk::PhysicalDeviceFeatures2
 			{.shaderDrawParameters = true},        // vk::PhysicalDeviceVulkan11Features
+			{.drawIndirectCount = true, .descriptorIndexing = true, .shaderSampledImageArrayNonUniformIndexing = true,
+			 .descriptorBindingSampledImageUpdateAfterBind = true, .descriptorBindingUpdateUnusedWhilePending = true,
+			 .descriptorBindingPartiallyBound = true, .descriptorBindingVariableDescriptorCount = true,
+			 .runtimeDescriptorArray = true, .timelineSemaphore = true}, // vk::PhysicalDeviceVulkan12Features
 			{.synchronization2 = true, .dynamicRendering = true},            // vk::PhysicalDeviceVulkan13Features
 			{.extendedDynamicState = true}        // vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT
 		};
@@ -477,6 +426,7 @@ namespace Core::Rendering::Vulkan {
 		_device = vk::raii::Device(_physicalDevice, deviceCreateInfo);
 		_graphicsQueue = vk::raii::Queue(_device, _queueFamilyIndices.graphicsFamily.value(), 0);
 		_presentQueue = vk::raii::Queue(_device, _queueFamilyIndices.presentFamily.value(), 0);
+		_transferQueue = vk::raii::Queue(_device, transferQueueFamily(), 0);
 	}
 	// endregion
 
@@ -490,6 +440,20 @@ namespace Core::Rendering::Vulkan {
 	}
 	// endregion
 
+	// region Memory
+	void Context::createAllocator() {
+		_allocator = std::make_unique<MemoryAllocator>(_physicalDevice, _device);
+	}
+
+	void Context::createUploader() {
+		_uploader = std::make_unique<Uploader>(*this);
+	}
+
+	void Context::createSamplerCache() {
+		_samplerCache = std::make_unique<SamplerCache>(_physicalDevice, _device);
+	}
+	// endregion
+
 	// region Command Pool
 	void Context::createCommandPool() {
 		vk::CommandPoolCreateInfo poolInfo{
@@ -0,0 +1,211 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/rendering/vulkan/Culling.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ASTRO_CULLING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(ASTRO_CULLING_X86) && (defined(__GNUC__) || defined(__clang__))
+#define ASTRO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ASTRO_TARGET_AVX2
+#endif
+
+namespace Core::Rendering::Vulkan {
+
+	// region SphereBounds
+	void SphereBounds::clear() {
+		_centerX.clear();
+		_centerY.clear();
+		_centerZ.clear();
+		_radius.clear();
+		_size = 0;
+	}
+
+	void SphereBounds::reserve(size_t count) {
+		const size_t padded = (count + LANES - 1) / LANES * LANES;
+		_centerX.reserve(padded);
+		_centerY.reserve(padded);
+		_centerZ.reserve(padded);
+		_radius.reserve(padded);
+	}
+
+	void SphereBounds::push(const glm::vec3 &center, float radius) {
+		// A padding sphere with a huge negative radius fails every plane test
+		if (_size == _centerX.size()) {
+			_centerX.resize(_size + LANES, 0.0f);
+			_centerY.resize(_size + LANES, 0.0f);
+			_centerZ.resize(_size + LANES, 0.0f);
+			_radius.resize(_size + LANES, -std::numeric_limits<float>::max());
+		}
+
+		_centerX[_size] = center.x;
+		_centerY[_size] = center.y;
+		_centerZ[_size] = center.z;
+		_radius[_size] = radius;
+		_size++;
+	}
+	// endregion
+
+	// region Kernels
+	static uint32_t cullScalar(const SphereBounds &bounds, const FrustumPlanes &planes, uint32_t *visible) {
+		uint32_t count = 0;
+		for (size_t i = 0; i < bounds.size(); i++) {
+			const glm::vec3 center{bounds.centerX()[i], bounds.centerY()[i], bounds.centerZ()[i]};
+			const float radius = bounds.radius()[i];
+
+			bool inside = true;
+			for (const auto &plane: planes)
+				inside = inside && glm::dot(glm::vec3(plane), center) + plane.w >= -radius;
+
+			if (inside)
+				visible[count++] = static_cast<uint32_t>(i);
+		}
+		return count;
+	}
+
+#ifdef ASTRO_CULLING_X86
+	static uint32_t cullSSE(const SphereBounds &bounds, const FrustumPlanes &planes, uint32_t *visible) {
+		__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (size_t p = 0; p < 6; p++) {
+			planeX[p] = _mm_set1_ps(planes[p].x);
+			planeY[p] = _mm_set1_ps(planes[p].y);
+			planeZ[p] = _mm_set1_ps(planes[p].z);
+			planeW[p] = _mm_set1_ps(planes[p].w);
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		uint32_t count = 0;
+
+		for (size_t i = 0; i < bounds.paddedSize(); i += 4) {
+			const __m128 x = _mm_loadu_ps(bounds.centerX() + i);
+			const __m128 y = _mm_loadu_ps(bounds.centerY() + i);
+			const __m128 z = _mm_loadu_ps(bounds.centerZ() + i);
+			const __m128 negRadius = _mm_sub_ps(zero, _mm_loadu_ps(bounds.radius() + i));
+
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (size_t p = 0; p < 6; p++) {
+				__m128 distance = _mm_add_ps(_mm_mul_ps(planeX[p], x), planeW[p]);
+				distance = _mm_add_ps(_mm_mul_ps(planeY[p], y), distance);
+				distance = _mm_add_ps(_mm_mul_ps(planeZ[p], z), distance);
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+			}
+
+			for (auto mask = static_cast<unsigned>(_mm_movemask_ps(inside)); mask != 0; mask &= mask - 1)
+				visible[count++] = static_cast<uint32_t>(i + std::countr_zero(mask));
+		}
+		return count;
+	}
+
+	ASTRO_TARGET_AVX2
+	static uint32_t cullAVX2(const SphereBounds &bounds, const FrustumPlanes &planes, uint32_t *visible) {
+		__m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+		for (size_t p = 0; p < 6; p++) {
+			planeX[p] = _mm256_set1_ps(planes[p].x);
+			planeY[p] = _mm256_set1_ps(planes[p].y);
+			planeZ[p] = _mm256_set1_ps(planes[p].z);
+			planeW[p] = _mm256_set1_ps(planes[p].w);
+		}
+
+		const __m256 zero = _mm256_setzero_ps();
+		uint32_t count = 0;
+
+		// 8 spheres x 6 planes per iteration
+		for (size_t i = 0; i < bounds.paddedSize(); i += 8) {
+			const __m256 x = _mm256_loadu_ps(bounds.centerX() + i);
+			const __m256 y = _mm256_loadu_ps(bounds.centerY() + i);
+			const __m256 z = _mm256_loadu_ps(bounds.centerZ() + i);
+			const __m256 negRadius = _mm256_sub_ps(zero, _mm256_loadu_ps(bounds.radius() + i));
+
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (size_t p = 0; p < 6; p++) {
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(planeX[p], x), planeW[p]);
+				distance = _mm256_add_ps(_mm256_mul_ps(planeY[p], y), distance);
+				distance = _mm256_add_ps(_mm256_mul_ps(planeZ[p], z), distance);
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+			}
+
+			for (auto mask = static_cast<unsigned>(_mm256_movemask_ps(inside)); mask != 0; mask &= mask - 1)
+				visible[count++] = static_cast<uint32_t>(i + std::countr_zero(mask));
+		}
+		return count;
+	}
+
+	static bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+		__cpuidex(info, 7, 0);
+		return osSavesYmm && (info[1] & (1 << 5));
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+	// endregion
+
+	CullingKernel bestCullingKernel() {
+#ifdef ASTRO_CULLING_X86
+		static const CullingKernel kernel = cpuSupportsAVX2() ? CullingKernel::AVX2 : CullingKernel::SSE;
+		return kernel;
+#else
+		return CullingKernel::Scalar;
+#endif
+	}
+
+	const char *cullingKernelName(CullingKernel kernel) {
+		switch (kernel) {
+			case CullingKernel::SSE: return "SSE";
+			case CullingKernel::AVX2: return "AVX2";
+			default: return "scalar";
+		}
+	}
+
+	uint32_t cullSpheres(const SphereBounds &bounds, const FrustumPlanes &planes, uint32_t *visible, CullingKernel kernel) {
+#ifdef ASTRO_CULLING_X86
+		if (kernel == CullingKernel::AVX2)
+			return cullAVX2(bounds, planes, visible);
+		if (kernel == CullingKernel::SSE)
+			return cullSSE(bounds, planes, visible);
+#endif
+		return cullScalar(bounds, planes, visible);
+	}
+
+	bool isSphereVisible(const FrustumPlanes &planes, const glm::vec3 &center, float radius) {
+		for (const auto &plane: planes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
+
+	bool coneTransform(const glm::mat4 &transform, glm::mat3 &cofactor) {
+		const glm::vec3 x(transform[0]);
+		const glm::vec3 y(transform[1]);
+		const glm::vec3 z(transform[2]);
+		cofactor = glm::mat3(glm::cross(y, z), glm::cross(z, x), glm::cross(x, y));
+
+		const float lengthX = glm::length(x);
+		const float lengthY = glm::length(y);
+		const float lengthZ = glm::length(z);
+		const float largest = std::max({lengthX, lengthY, lengthZ});
+		return largest - std::min({lengthX, lengthY, lengthZ}) <= CONE_SCALE_TOLERANCE * largest;
+	}
+
+	bool isConeBackfacing(const glm::vec4 &cone, const glm::vec3 &center, float radius, const glm::vec3 &eye) {
+		const glm::vec3 direction = center - eye;
+		return glm::dot(direction, glm::vec3(cone)) >= cone.w * glm::length(direction) + radius;
+	}
+}
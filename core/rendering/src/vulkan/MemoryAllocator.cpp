@@ -0,0 +1,246 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/rendering/vulkan/MemoryAllocator.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace Core::Rendering::Vulkan {
+
+	static vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// region Allocation
+	Allocation::~Allocation() {
+		release();
+	}
+
+	Allocation::Allocation(Allocation &&other) noexcept
+		: _allocator(std::exchange(other._allocator, nullptr)),
+		  _block(std::exchange(other._block, nullptr)),
+		  _offset(std::exchange(other._offset, 0)),
+		  _size(std::exchange(other._size, 0)) {}
+
+	Allocation &Allocation::operator=(Allocation &&other) noexcept {
+		if (this != &other) {
+			release();
+			_allocator = std::exchange(other._allocator, nullptr);
+			_block = std::exchange(other._block, nullptr);
+			_offset = std::exchange(other._offset, 0);
+			_size = std::exchange(other._size, 0);
+		}
+		return *this;
+	}
+
+	vk::DeviceMemory Allocation::memory() const {
+		return _block ? *_block->memory : vk::DeviceMemory{};
+	}
+
+	void *Allocation::mapped() const {
+		if (!_block || !_block->mapped)
+			return nullptr;
+		return static_cast<char *>(_block->mapped) + _offset;
+	}
+
+	void Allocation::release() {
+		if (_allocator)
+			_allocator->free(_block, _offset, _size);
+		_allocator = nullptr;
+		_block = nullptr;
+		_offset = 0;
+		_size = 0;
+	}
+	// endregion
+
+	// region Allocator
+	MemoryAllocator::MemoryAllocator(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+	                                 vk::DeviceSize blockSize)
+		: _device(device), _memoryProperties(physicalDevice.getMemoryProperties()) {
+
+		// Small heaps (e.g. the 256MB host visible device local heap) get proportionally smaller blocks
+		_blockSizes.resize(_memoryProperties.memoryHeapCount);
+		for (uint32_t i = 0; i < _memoryProperties.memoryHeapCount; i++)
+			_blockSizes[i] = std::min(blockSize, _memoryProperties.memoryHeaps[i].size / 8);
+
+		_pools.resize(_memoryProperties.memoryTypeCount * 2);
+	}
+
+	uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const {
+		for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; i++)
+			if ((typeFilter & (1 << i)) && (_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+				return i;
+
+		throw std::runtime_error("failed to find suitable memory type!");
+	}
+
+	Allocation MemoryAllocator::allocate(const vk::MemoryRequirements &requirements, vk::MemoryPropertyFlags properties,
+	                                     ResourceKind kind) {
+		const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+		const uint32_t pool = poolIndex(memoryType, kind);
+		const vk::DeviceSize blockSize = _blockSizes[_memoryProperties.memoryTypes[memoryType].heapIndex];
+
+		std::lock_guard lock(_mutex);
+
+		Block *target = nullptr;
+		vk::DeviceSize offset = 0;
+
+		// Large resources get their own block instead of wasting most of a shared one
+		if (requirements.size > blockSize / 2) {
+			target = &createBlock(pool, requirements.size, true);
+			target->freeRanges.clear();
+			target->allocationCount = 1;
+		} else {
+			for (auto &block: _pools[pool].blocks) {
+				if (!block->dedicated && tryAllocate(*block, requirements.size, requirements.alignment, offset)) {
+					target = block.get();
+					break;
+				}
+			}
+			if (!target) {
+				target = &createBlock(pool, blockSize, false);
+				if (!tryAllocate(*target, requirements.size, requirements.alignment, offset))
+					throw std::runtime_error("failed to sub-allocate from a new memory block!");
+			}
+		}
+
+		Allocation allocation;
+		allocation._allocator = this;
+		allocation._block = target;
+		allocation._offset = offset;
+		allocation._size = requirements.size;
+		return allocation;
+	}
+
+	MemoryAllocator::Block &MemoryAllocator::createBlock(uint32_t pool, vk::DeviceSize size, bool dedicated) {
+		const uint32_t memoryType = pool / 2;
+
+		auto block = std::make_unique<Block>();
+		block->memory = vk::raii::DeviceMemory(_device, vk::MemoryAllocateInfo{.allocationSize = size, .memoryTypeIndex = memoryType});
+		block->size = size;
+		block->dedicated = dedicated;
+		block->pool = pool;
+		block->freeRanges.emplace(0, size);
+
+		if (_memoryProperties.memoryTypes[memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)
+			block->mapped = block->memory.mapMemory(0, vk::WholeSize);
+
+		_pools[pool].blocks.push_back(std::move(block));
+		return *_pools[pool].blocks.back();
+	}
+
+	bool MemoryAllocator::tryAllocate(Block &block, vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize &outOffset) {
+		// Best fit: keep the range that leaves the least space behind
+		auto best = block.freeRanges.end();
+		vk::DeviceSize bestWaste = std::numeric_limits<vk::DeviceSize>::max();
+		vk::DeviceSize bestOffset = 0;
+
+		for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it) {
+			const auto [rangeOffset, rangeSize] = *it;
+			const vk::DeviceSize alignedOffset = alignUp(rangeOffset, alignment);
+			if (alignedOffset + size > rangeOffset + rangeSize)
+				continue;
+
+			const vk::DeviceSize waste = rangeSize - size;
+			if (waste < bestWaste) {
+				best = it;
+				bestWaste = waste;
+				bestOffset = alignedOffset;
+				if (waste == 0)
+					break;
+			}
+		}
+
+		if (best == block.freeRanges.end())
+			return false;
+
+		const auto [rangeOffset, rangeSize] = *best;
+		block.freeRanges.erase(best);
+
+		// Alignment padding in front and the tail stay available as separate ranges
+		if (bestOffset > rangeOffset)
+			block.freeRanges.emplace(rangeOffset, bestOffset - rangeOffset);
+		if (bestOffset + size < rangeOffset + rangeSize)
+			block.freeRanges.emplace(bestOffset + size, rangeOffset + rangeSize - bestOffset - size);
+
+		block.allocationCount++;
+		outOffset = bestOffset;
+		return true;
+	}
+
+	void MemoryAllocator::free(Block *block, vk::DeviceSize offset, vk::DeviceSize size) {
+		std::lock_guard lock(_mutex);
+
+		auto &blocks = _pools[block->pool].blocks;
+		block->allocationCount--;
+
+		if (block->dedicated) {
+			std::erase_if(blocks, [block](const auto &b) { return b.get() == block; });
+			return;
+		}
+
+		// Insert and coalesce with the previous and next free ranges
+		auto it = block->freeRanges.emplace(offset, size).first;
+		if (auto next = std::next(it); next != block->freeRanges.end() && it->first + it->second == next->first) {
+			it->second += next->second;
+			block->freeRanges.erase(next);
+		}
+		if (it != block->freeRanges.begin()) {
+			if (auto prev = std::prev(it); prev->first + prev->second == it->first) {
+				prev->second += it->second;
+				block->freeRanges.erase(it);
+			}
+		}
+
+		// Keep one empty block per pool around to avoid allocate/free churn
+		if (block->allocationCount == 0) {
+			const auto emptyBlocks = std::ranges::count_if(blocks, [](const auto &b) {
+				return !b->dedicated && b->allocationCount == 0;
+			});
+			if (emptyBlocks > 1)
+				std::erase_if(blocks, [block](const auto &b) { return b.get() == block; });
+		}
+	}
+	// endregion
+
+	// region Statistics
+	void MemoryAllocator::accumulate(const Block &block, MemoryStats &stats) {
+		stats.blockCount++;
+		if (block.dedicated)
+			stats.dedicatedBlockCount++;
+		stats.allocationCount += block.allocationCount;
+		stats.blockBytes += block.size;
+
+		vk::DeviceSize blockFree = 0;
+		for (const auto &[offset, size]: block.freeRanges) {
+			blockFree += size;
+			stats.largestFreeRange = std::max(stats.largestFreeRange, size);
+		}
+		stats.freeBytes += blockFree;
+		stats.usedBytes += block.size - blockFree;
+	}
+
+	MemoryStats MemoryAllocator::stats() const {
+		std::lock_guard lock(_mutex);
+
+		MemoryStats stats;
+		for (const auto &pool: _pools)
+			for (const auto &block: pool.blocks)
+				accumulate(*block, stats);
+		return stats;
+	}
+
+	MemoryStats MemoryAllocator::stats(uint32_t memoryTypeIndex) const {
+		std::lock_guard lock(_mutex);
+
+		MemoryStats stats;
+		for (ResourceKind kind: {ResourceKind::Linear, ResourceKind::Optimal})
+			for (const auto &block: _pools[poolIndex(memoryTypeIndex, kind)].blocks)
+				accumulate(*block, stats);
+		return stats;
+	}
+	// endregion
+}
@@ -4,21 +4,159 @@
 
 
 #include <core/rendering/vulkan/MeshManager.hpp>
+#include <core/rendering/vulkan/Vertex.hpp>
+#include <core/utils/MeshQuantization.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 namespace Core::Rendering::Vulkan {
+
+	static vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Bounding box, and a sphere around its center: loose but cheap and stable for culling
+	static void computeBounds(const MeshData& meshData, MeshManager::Mesh& mesh) {
+		glm::vec3 min = meshData.vertices.front().pos;
+		glm::vec3 max = min;
+		for (const auto& vertex : meshData.vertices) {
+			min = glm::min(min, vertex.pos);
+			max = glm::max(max, vertex.pos);
+		}
+
+		const glm::vec3 center = (min + max) * 0.5f;
+		float radiusSquared = 0.0f;
+		for (const auto& vertex : meshData.vertices) {
+			const glm::vec3 offset = vertex.pos - center;
+			radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+		}
+
+		mesh.boundsMin = min;
+		mesh.boundsMax = max;
+		mesh.boundingSphere = {center, std::sqrt(radiusSquared)};
+	}
+
 	MeshManager::MeshManager(Context& context)
 		: _context(context) {}
 
 	MeshID MeshManager::createMesh(const MeshData& meshData) {
+		if (meshData.vertices.empty() || meshData.indices.empty())
+			throw std::runtime_error("cannot create an empty mesh");
+		if (meshData.lods.size() > MAX_MESH_LODS)
+			throw std::runtime_error("mesh has too many levels of detail");
+		for (const MeshLod& lod : meshData.lods) {
+			if (lod.indexCount == 0 || lod.firstIndex > meshData.indices.size() || lod.indexCount > meshData.indices.size() - lod.firstIndex)
+				throw std::runtime_error("mesh level of detail is out of its indices");
+		}
+		for (const Meshlet& meshlet : meshData.meshlets) {
+			if (meshlet.firstIndex > meshData.indices.size() || meshlet.triangleCount > (meshData.indices.size() - meshlet.firstIndex) / 3)
+				throw std::runtime_error("meshlet is out of its mesh indices");
+		}
+
+		// Meshes whose attributes survive quantization are stored at 16 bytes per vertex instead of 44
+		const VertexFormat format = Utils::chooseVertexFormat(meshData);
+		Utils::QuantizedMesh quantized;
+		if (format != VertexFormat::Full)
+			quantized = Utils::quantizeMesh(meshData, format);
+
+		const vk::DeviceSize stride = vertexStride(format);
+		const void* vertexData = format == VertexFormat::Full
+			                         ? static_cast<const void*>(meshData.vertices.data())
+			                         : static_cast<const void*>(quantized.vertices.data());
+		const vk::DeviceSize vertexBytes = stride * meshData.vertices.size();
+
+		if (meshData.indexType == IndexType::Uint16 && meshData.vertices.size() > MAX_UINT16_INDEXED_VERTICES)
+			throw std::runtime_error("mesh has too many vertices for 16 bit indices");
+
+		// Indices are narrowed here, the uploader copies them to staging memory right away
+		std::vector<uint16_t> narrowIndices;
+		if (meshData.indexType == IndexType::Uint16)
+			narrowIndices.assign(meshData.indices.begin(), meshData.indices.end());
+
+		const vk::DeviceSize indexStride = indexSize(meshData.indexType);
+		const void* indexData = meshData.indexType == IndexType::Uint16
+			                        ? static_cast<const void*>(narrowIndices.data())
+			                        : static_cast<const void*>(meshData.indices.data());
+		const vk::DeviceSize indexBytes = indexStride * meshData.indices.size();
 
 		Mesh mesh{};
+		mesh.page = findPage(vertexBytes, stride, indexBytes, indexStride);
+		GeometryPage& page = _pages[mesh.page];
 
-		_context.createDeviceLocalBuffer(meshData.vertices, vk::BufferUsageFlagBits::eVertexBuffer, mesh.vertexBuffer, mesh.vertexMemory);
-		_context.createDeviceLocalBuffer(meshData.indices, vk::BufferUsageFlagBits::eIndexBuffer, mesh.indexBuffer, mesh.indexMemory);
+		// vertexOffset and firstIndex count elements, so offsets must be multiples of the element size
+		const vk::DeviceSize vertexOffset = alignUp(page.vertexUsed, stride);
+		const vk::DeviceSize indexOffset = alignUp(page.indexUsed, indexStride);
+		page.vertexUsed = vertexOffset + vertexBytes;
+		page.indexUsed = indexOffset + indexBytes;
 
-		mesh.indexCount = static_cast<uint32_t>(meshData.indices.size());
-		_meshes.push_back(std::move(mesh));
+		mesh.vertexOffset = static_cast<int32_t>(vertexOffset / stride);
+		mesh.indexType = meshData.indexType;
+
+		// Meshes without levels of detail draw every index
+		const auto baseIndex = static_cast<uint32_t>(indexOffset / indexStride);
+		if (meshData.lods.empty()) {
+			mesh.lods[0] = MeshLod{baseIndex, static_cast<uint32_t>(meshData.indices.size()), 0.0f};
+		} else {
+			mesh.lodCount = static_cast<uint32_t>(meshData.lods.size());
+			for (uint32_t i = 0; i < mesh.lodCount; i++) {
+				const MeshLod& lod = meshData.lods[i];
+				mesh.lods[i] = MeshLod{baseIndex + lod.firstIndex, lod.indexCount, lod.error};
+			}
+		}
+		mesh.firstIndex = mesh.lods[0].firstIndex;
+		mesh.indexCount = mesh.lods[0].indexCount;
+		computeBounds(meshData, mesh);
+
+		mesh.firstMeshlet = static_cast<uint32_t>(_meshlets.size());
+		mesh.meshletCount = static_cast<uint32_t>(meshData.meshlets.size());
+		for (Meshlet meshlet : meshData.meshlets) {
+			meshlet.firstIndex += baseIndex;
+			_meshlets.push_back(meshlet);
+		}
+
+		mesh.vertexFormat = format;
+		if (format != VertexFormat::Full) {
+			mesh.positionOffset = quantized.offset;
+			mesh.positionScale = quantized.scale;
+
+			std::cout << "[ASTRO CORE] [VULKAN] [MESH] " << meshData.vertices.size() << " vertices quantized, "
+					<< sizeof(Core::Vertex) * meshData.vertices.size() / 1024 << " KiB -> " << vertexBytes / 1024
+					<< " KiB" << std::endl;
+		}
+
+		auto& uploader = _context.uploader();
+		uploader.uploadBuffer(vertexData, vertexBytes, *page.vertexBuffer, vertexOffset);
+		mesh.ready = uploader.uploadBuffer(indexData, indexBytes, *page.indexBuffer, indexOffset);
+
+		_meshes.push_back(mesh);
 
 		return static_cast<MeshID>(_meshes.size() - 1);
 	}
+
+	uint32_t MeshManager::findPage(vk::DeviceSize vertexBytes, vk::DeviceSize vertexStride, vk::DeviceSize indexBytes,
+	                               vk::DeviceSize indexStride) {
+		for (uint32_t i = 0; i < _pages.size(); i++) {
+			const auto& page = _pages[i];
+			if (alignUp(page.vertexUsed, vertexStride) + vertexBytes <= page.vertexCapacity &&
+				alignUp(page.indexUsed, indexStride) + indexBytes <= page.indexCapacity)
+				return i;
+		}
+
+		createPage(std::max(VERTEX_PAGE_SIZE, vertexBytes), std::max(INDEX_PAGE_SIZE, indexBytes));
+		return static_cast<uint32_t>(_pages.size() - 1);
+	}
+
+	void MeshManager::createPage(vk::DeviceSize vertexCapacity, vk::DeviceSize indexCapacity) {
+		GeometryPage page;
+		_context.createBuffer(vertexCapacity, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+		                      vk::MemoryPropertyFlagBits::eDeviceLocal, page.vertexBuffer, page.vertexMemory);
+		_context.createBuffer(indexCapacity, vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+		                      vk::MemoryPropertyFlagBits::eDeviceLocal, page.indexBuffer, page.indexMemory);
+		page.vertexCapacity = vertexCapacity;
+		page.indexCapacity = indexCapacity;
+
+		_pages.push_back(std::move(page));
+	}
 }
@@ -4,27 +4,187 @@
 
 #include <core/rendering/vulkan/PipelineManager.hpp>
 #include <core/rendering/vulkan/Vertex.hpp>
+#include <core/utils/Hash.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
 
 namespace Core::Rendering::Vulkan {
-	PipelineManager::PipelineManager(Context &ctx, Swapchain &sc)
-		: _context(ctx), _swapchain(sc) {
+	using Clock = std::chrono::steady_clock;
+
+	static double elapsedMs(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	using Utils::hashBytes;
+	using Utils::hashValue;
+
+	static uint64_t hashConfig(const PipelineConfig& config) {
+		// Field by field, the struct padding is not part of the key
+		uint64_t hash = hashValue(config.depthTestEnable, Utils::HASH_SEED);
+		hash = hashValue(config.depthWriteEnable, hash);
+		hash = hashValue(config.depthCompareOp, hash);
+		hash = hashValue(config.blendEnable, hash);
+		hash = hashValue(config.polygonMode, hash);
+		hash = hashValue(static_cast<VkCullModeFlags>(config.cullMode), hash);
+		hash = hashValue(config.frontFace, hash);
+		hash = hashValue(config.rasterizationSamples, hash);
+		return hashValue(config.vertexFormat, hash);
+	}
+
+	size_t PipelineManager::VariantKeyHash::operator()(const VariantKey& key) const noexcept {
+		uint64_t hash = hashValue(key.shaderHash, Utils::HASH_SEED);
+		hash = hashValue(hashConfig(key.config), hash);
+		hash = hashValue(key.colorFormat, hash);
+		return static_cast<size_t>(hashValue(key.depthFormat, hash));
+	}
+
+	PipelineManager::PipelineManager(Context &ctx, Swapchain &sc, vk::DescriptorSetLayout textureSetLayout, std::string cachePath)
+		: _context(ctx), _swapchain(sc), _cachePath(std::move(cachePath)), _textureSetLayout(textureSetLayout) {
 		createDescriptorSetLayout();
 		createPipelineLayout();
+		createPipelineCache();
+	}
+
+	void PipelineManager::createPipelineCache() {
+		std::vector<char> data = readCacheFile();
+
+		// A cache from another driver or GPU is rejected by some implementations and undefined on others,
+		// so only hand it over when its header matches this device
+		if (!data.empty()) {
+			const vk::PhysicalDeviceProperties properties = _context.physicalDevice().getProperties();
+
+			vk::PipelineCacheHeaderVersionOne header{};
+			bool valid = data.size() >= sizeof(header);
+			if (valid) {
+				memcpy(&header, data.data(), sizeof(header));
+				valid = header.headerSize >= sizeof(header) && header.headerSize <= data.size() &&
+						header.headerVersion == vk::PipelineCacheHeaderVersion::eOne &&
+						header.vendorID == properties.vendorID &&
+						header.deviceID == properties.deviceID &&
+						memcmp(header.pipelineCacheUUID.data(), properties.pipelineCacheUUID.data(), vk::UuidSize) == 0;
+			}
+
+			if (!valid) {
+				std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] discarding pipeline cache from another device or driver: "
+						<< _cachePath << std::endl;
+				data.clear();
+			}
+		}
+
+		const auto start = Clock::now();
+		_pipelineCache = vk::raii::PipelineCache(_context.device(), vk::PipelineCacheCreateInfo{
+			.initialDataSize = data.size(),
+			.pInitialData = data.empty() ? nullptr : data.data()
+		});
+
+		std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] pipeline cache "
+				<< (data.empty() ? "created empty" : "loaded " + std::to_string(data.size()) + " bytes from " + _cachePath)
+				<< " in " << elapsedMs(start) << " ms" << std::endl;
+	}
+
+	std::vector<char> PipelineManager::readCacheFile() const {
+		std::ifstream file(_cachePath, std::ios::ate | std::ios::binary);
+		if (!file.is_open())
+			return {};
+
+		std::vector<char> data(file.tellg());
+		file.seekg(0, std::ios::beg);
+		file.read(data.data(), static_cast<std::streamsize>(data.size()));
+		return file ? data : std::vector<char>{};
+	}
+
+	void PipelineManager::saveCache() const {
+		const std::vector<uint8_t> data = _pipelineCache.getData();
+
+		// Write next to the destination and rename, so a crash never leaves a truncated cache behind
+		const std::filesystem::path path(_cachePath);
+		std::filesystem::path tmpPath = path;
+		tmpPath += ".tmp";
+		{
+			std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] failed to write pipeline cache: " << tmpPath << std::endl;
+				return;
+			}
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tmpPath, path, error);
+		if (error) {
+			std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] failed to save pipeline cache: " << error.message() << std::endl;
+			return;
+		}
+
+		std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] saved " << data.size() << " bytes of pipeline cache to " << _cachePath << std::endl;
+	}
+
+	void PipelineManager::registerShader(const std::string &name, const std::vector<char> &code) {
+		std::lock_guard lock(_variantsMutex);
+		_shaders.insert_or_assign(name, Shader{
+			.module = createShaderModule(_context.device(), code),
+			.hash = hashBytes(code.data(), code.size())
+		});
 	}
 
 	void PipelineManager::createPipeline(const std::string &name, const std::vector<char> &code,
 	                                     const PipelineConfig &config) {
+		registerShader(name, code);
+		getVariant(name, config, false);
+	}
 
-		vk::raii::Device& device = _context.device();
-		vk::Format colorFormat = _swapchain.colorFormat();
-		vk::Format depthFormat = _swapchain.depthFormat();
+	vk::Pipeline PipelineManager::getVariant(const std::string &shader, const PipelineConfig &config, bool onFirstUse) {
+		Variant* variant;
+		vk::ShaderModule shaderModule;
+		const vk::Format colorFormat = _swapchain.colorFormat();
+		const vk::Format depthFormat = _swapchain.depthFormat();
+		{
+			std::lock_guard lock(_variantsMutex);
+			auto shaderIt = _shaders.find(shader);
+			if (shaderIt == _shaders.end())
+				throw std::runtime_error("Shader not found: " + shader);
+			shaderModule = *shaderIt->second.module;
 
-		const vk::raii::ShaderModule shaderModule = createShaderModule(device, code);
+			auto& slot = _variants[VariantKey{shaderIt->second.hash, config, colorFormat, depthFormat}];
+			if (!slot)
+				slot = std::make_unique<Variant>();
+			variant = slot.get();
+		}
+
+		// Compiled outside the lock so different variants build concurrently, callers of the same one wait
+		std::call_once(variant->built, [&] {
+			const auto start = Clock::now();
+			variant->pipeline = buildGraphicsPipeline(shaderModule, config, colorFormat, depthFormat);
+			std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] created graphics pipeline variant of " << shader
+					<< " in " << elapsedMs(start) << " ms" << std::endl;
+			if (onFirstUse)
+				std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] variant of " << shader << " (vertex format "
+						<< static_cast<uint32_t>(config.vertexFormat) << ") was compiled on first use, prewarm it" << std::endl;
+		});
+		return *variant->pipeline;
+	}
+
+	void PipelineManager::prewarm(const std::vector<PipelineVariant> &variants, Utils::ThreadPool &threads) {
+		const auto start = Clock::now();
+		threads.parallelFor(static_cast<uint32_t>(variants.size()), [&](uint32_t i) {
+			getVariant(variants[i].shader, variants[i].config, false);
+		});
+		std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] prewarmed " << variants.size() << " pipeline variants in "
+				<< elapsedMs(start) << " ms" << std::endl;
+	}
+
+	vk::raii::Pipeline PipelineManager::buildGraphicsPipeline(vk::ShaderModule shaderModule, const PipelineConfig &config,
+	                                                          vk::Format colorFormat, vk::Format depthFormat) const {
+		const vk::raii::Device& device = _context.device();
 
 		vk::PipelineShaderStageCreateInfo vertShaderStageInfo{
 			.stage = vk::ShaderStageFlagBits::eVertex,
 			.module = shaderModule,
-			.pName = "vertMain"
+			.pName = vertexEntryPoint(config.vertexFormat)
 		};
 
 		vk::PipelineShaderStageCreateInfo fragShaderStageInfo{
@@ -35,13 +195,12 @@ namespace Core::Rendering::Vulkan {
 
 		vk::PipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
-		auto bindingDescription = Vulkan::Vertex::getBindingDescription();
-		auto attributeDescriptions = Vulkan::Vertex::getAttributeDescriptions();
+		const VertexInput vertexInput = getVertexInput(config.vertexFormat);
 		vk::PipelineVertexInputStateCreateInfo vertexInputInfo {
 			.vertexBindingDescriptionCount =1,
-			.pVertexBindingDescriptions = &bindingDescription,
-			.vertexAttributeDescriptionCount = attributeDescriptions.size(),
-			.pVertexAttributeDescriptions = attributeDescriptions.data()
+			.pVertexBindingDescriptions = &vertexInput.binding,
+			.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInput.attributes.size()),
+			.pVertexAttributeDescriptions = vertexInput.attributes.data()
 		};
 
 		vk::PipelineInputAssemblyStateCreateInfo inputAssembly{.topology = vk::PrimitiveTopology::eTriangleList};
@@ -102,13 +261,42 @@ namespace Core::Rendering::Vulkan {
 			{.colorAttachmentCount = 1, .pColorAttachmentFormats = &colorFormat, .depthAttachmentFormat = depthFormat}};
 
 
-		_pipelines.emplace(name,vk::raii::Pipeline(device, nullptr, pipelineCreateInfoChain.get<vk::GraphicsPipelineCreateInfo>()));
+		return {device, _pipelineCache, pipelineCreateInfoChain.get<vk::GraphicsPipelineCreateInfo>()};
+	}
+
+	void PipelineManager::createComputePipeline(const std::string &name, const std::vector<char> &code,
+	                                            const std::string &entryPoint) {
+		const auto start = Clock::now();
+		vk::raii::Device& device = _context.device();
+
+		const vk::raii::ShaderModule shaderModule = createShaderModule(device, code);
+
+		vk::ComputePipelineCreateInfo pipelineInfo{
+			.stage = {
+				.stage = vk::ShaderStageFlagBits::eCompute,
+				.module = shaderModule,
+				.pName = entryPoint.c_str()
+			},
+			.layout = _pipelineLayout
+		};
+
+		_pipelines.emplace(name, vk::raii::Pipeline(device, _pipelineCache, pipelineInfo));
+
+		std::cout << "[ASTRO CORE] [VULKAN] [PIPELINE] created compute pipeline " << name << " in " << elapsedMs(start) << " ms" << std::endl;
 	}
 
 	void PipelineManager::createDescriptorSetLayout() {
+		// Graphics and culling passes share one layout: the instance data is read by both,
+		// the compute passes fill the visible instance list and the indirect commands the draws consume.
+		// Binding 1 is left free, textures are read from the bindless set 1. Quantized meshes decode their
+		// positions with the batch entries of binding 4.
 		std::array bindings = {
 			vk::DescriptorSetLayoutBinding( 0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex, nullptr),
-			vk::DescriptorSetLayoutBinding( 1, vk::DescriptorType::eCombinedImageSampler, MAX_TEXTURES, vk::ShaderStageFlagBits::eFragment, nullptr)
+			vk::DescriptorSetLayoutBinding( 2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eCompute, nullptr),
+			vk::DescriptorSetLayoutBinding( 3, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eCompute, nullptr),
+			vk::DescriptorSetLayoutBinding( 4, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eCompute, nullptr),
+			vk::DescriptorSetLayoutBinding( 5, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute, nullptr),
+			vk::DescriptorSetLayoutBinding( 6, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute, nullptr)
 		};
 
 		vk::DescriptorSetLayoutCreateInfo layoutInfo{.bindingCount = bindings.size(), .pBindings = bindings.data()};
@@ -116,17 +304,20 @@ namespace Core::Rendering::Vulkan {
 	}
 
 	void PipelineManager::createPipelineLayout() {
-		vk::PushConstantRange pushRange{
-			.stageFlags = vk::ShaderStageFlagBits::eFragment,
+		// Texture indices come from the instance buffer, only the culling passes use push constants
+		vk::PushConstantRange cullRange{
+			.stageFlags = vk::ShaderStageFlagBits::eCompute,
 			.offset = 0,
-			.size = sizeof(uint32_t)
+			.size = sizeof(CullConstants)
 		};
 
+		const std::array setLayouts = {*_descriptorSetLayout, _textureSetLayout};
+
 		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{
-			.setLayoutCount = 1,
-			.pSetLayouts = &*_descriptorSetLayout,
+			.setLayoutCount = setLayouts.size(),
+			.pSetLayouts = setLayouts.data(),
 			.pushConstantRangeCount = 1,
-			.pPushConstantRanges = &pushRange
+			.pPushConstantRanges = &cullRange
 		};
 
 		_pipelineLayout = vk::raii::PipelineLayout(_context.device(), pipelineLayoutInfo);
@@ -2,9 +2,13 @@
 // Created by eharquin on 12/19/25.
 //
 
-#include <chrono>
+#include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <optional>
+#include <tuple>
 #include <core/rendering/vulkan/Renderer.hpp>
+#include <core/rendering/vulkan/Vertex.hpp>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
@@ -20,13 +24,24 @@ namespace Core::Rendering::Vulkan {
 			static_cast<uint32_t>(_window.height())
 		});
 
-		_pipelineManager = std::make_unique<PipelineManager>(_context, *_swapchain);
+		_bindlessTable = std::make_unique<BindlessTable>(_context);
+		_pipelineManager = std::make_unique<PipelineManager>(_context, *_swapchain, _bindlessTable->layout());
 		_meshManager = std::make_unique<MeshManager>(_context);
-		_textureManager = std::make_unique<TextureManager>(_context);
+		_textureManager = std::make_unique<TextureManager>(_context, *_bindlessTable);
+		_workerThreads = std::make_unique<Utils::ThreadPool>();
+
+		const vk::PhysicalDeviceProperties properties = _context.physicalDevice().getProperties();
+		_maxDrawIndirectCount = properties.limits.maxDrawIndirectCount;
+		_cpuCulling = properties.deviceType == vk::PhysicalDeviceType::eCpu;
+
+		std::cout << "[ASTRO CORE] [VULKAN] [INIT] Culling on "
+				<< (_cpuCulling ? std::string("CPU (") + cullingKernelName(bestCullingKernel()) + ")" : std::string("GPU"))
+				<< std::endl;
 
 		createSyncObjects();
 		createCommandBuffers();
 		createUniformBuffers();
+		createDrawBuffers();
 		createDescriptorPool();
 		createDescriptorSets();
 	}
@@ -39,6 +54,7 @@ namespace Core::Rendering::Vulkan {
 		// Wait for the current frame to finish
 		while (vk::Result::eTimeout == device.waitForFences(*_inFlightFences[_frameIndex], vk::True, UINT64_MAX)) {}
 		device.resetFences(*_inFlightFences[_frameIndex]);
+		_textureManager->beginFrame(_frameNumber);
 
 		auto [result, imageIndex] = swapchain.acquireNextImage(
 			UINT64_MAX,
@@ -53,13 +69,19 @@ namespace Core::Rendering::Vulkan {
 		if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
 			throw std::runtime_error("Failed to acquire swap chain image!");
 
-		// Update uniforms
+		// Update uniforms, instances and indirect commands
 		updateUniformBuffer(_frameIndex);
+		updateDrawBuffers(_frameIndex);
+		if (_cpuCulling)
+			cullOnCpu(_frameIndex);
 
 		// Reset and record command buffer for this frame
 		_commandBuffers[_frameIndex].reset();
 		recordCommandBuffer(imageIndex);
 
+		// Submit pending uploads first so the graphics queue acquires them before this frame
+		_context.uploader().flush();
+
 		// Submit command buffer
 		vk::PipelineStageFlags waitStages = vk::PipelineStageFlagBits::eColorAttachmentOutput;
 		vk::SubmitInfo submitInfo{
@@ -102,10 +124,12 @@ namespace Core::Rendering::Vulkan {
 
 		// Advance to next frame
 		_frameIndex = (_frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+		_frameNumber++;
 	}
 
 	void Renderer::shutdown() {
 		_context.device().waitIdle();
+		_pipelineManager->saveCache();
 	}
 
 	void Renderer::createSyncObjects() {
@@ -140,18 +164,80 @@ namespace Core::Rendering::Vulkan {
 		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
 			vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
 			vk::raii::Buffer buffer({});
-			vk::raii::DeviceMemory bufferMem({});
+			Allocation bufferMem;
 			_context.createBuffer(bufferSize, vk::BufferUsageFlagBits::eUniformBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer, bufferMem);
 			_uniformBuffers.emplace_back(std::move(buffer));
 			_uniformBuffersMemory.emplace_back(std::move(bufferMem));
-			_uniformBuffersMapped.emplace_back( _uniformBuffersMemory[i].mapMemory(0, bufferSize));
+			_uniformBuffersMapped.emplace_back(_uniformBuffersMemory[i].mapped());
+		}
+	}
+
+	void Renderer::createDrawBuffers() {
+		// The CPU culling path writes the visible list and the indirect commands itself
+		const vk::MemoryPropertyFlags cullOutput = _cpuCulling
+			? vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+			: vk::MemoryPropertyFlagBits::eDeviceLocal;
+
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+			reserveBuffer(_instanceBuffers[i], sizeof(InstanceData) * INITIAL_INSTANCE_CAPACITY, vk::BufferUsageFlagBits::eStorageBuffer,
+			              vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+			reserveBuffer(_cullBatchBuffers[i], sizeof(CullBatch) * INITIAL_INSTANCE_CAPACITY, vk::BufferUsageFlagBits::eStorageBuffer,
+			              vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+			reserveBuffer(_visibleInstanceBuffers[i], sizeof(uint32_t) * INITIAL_INSTANCE_CAPACITY, vk::BufferUsageFlagBits::eStorageBuffer,
+			              cullOutput);
+			reserveBuffer(_drawCommandBuffers[i], sizeof(vk::DrawIndexedIndirectCommand) * INITIAL_INSTANCE_CAPACITY,
+			              vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer, cullOutput);
+			reserveBuffer(_drawCountBuffers[i], sizeof(uint32_t) * 2 * INITIAL_INSTANCE_CAPACITY,
+			              vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+			              cullOutput);
+		}
+	}
+
+	bool Renderer::reserveBuffer(GrowableBuffer& growable, vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties) {
+		if (size <= growable.capacity)
+			return false;
+
+		// Grow geometrically so a steadily growing scene does not reallocate every frame
+		const vk::DeviceSize capacity = std::max(size, growable.capacity * 2);
+		vk::raii::Buffer buffer({});
+		Allocation bufferMem;
+		_context.createBuffer(capacity, usage, properties, buffer, bufferMem);
+		growable.buffer = std::move(buffer);
+		growable.memory = std::move(bufferMem);
+		growable.capacity = capacity;
+		return true;
+	}
+
+	void Renderer::writeDrawDescriptors(uint32_t frameIndex) {
+		// The frame's descriptor set is idle here: its fence was waited on before any resize
+		const std::array<vk::Buffer, 5> buffers = {
+			*_instanceBuffers[frameIndex].buffer,
+			*_visibleInstanceBuffers[frameIndex].buffer,
+			*_cullBatchBuffers[frameIndex].buffer,
+			*_drawCommandBuffers[frameIndex].buffer,
+			*_drawCountBuffers[frameIndex].buffer
+		};
+
+		std::array<vk::DescriptorBufferInfo, 5> bufferInfos;
+		std::array<vk::WriteDescriptorSet, 5> writes;
+		for (uint32_t i = 0; i < buffers.size(); i++) {
+			bufferInfos[i] = vk::DescriptorBufferInfo{.buffer = buffers[i], .offset = 0, .range = vk::WholeSize};
+			writes[i] = vk::WriteDescriptorSet{
+				.dstSet = _descriptorSets[frameIndex],
+				.dstBinding = 2 + i,
+				.dstArrayElement = 0,
+				.descriptorCount = 1,
+				.descriptorType = vk::DescriptorType::eStorageBuffer,
+				.pBufferInfo = &bufferInfos[i]
+			};
 		}
+		_context.device().updateDescriptorSets(writes, {});
 	}
 
 	void Renderer::createDescriptorPool() {
 		std::array poolSize {
 			vk::DescriptorPoolSize( vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT),
-			vk::DescriptorPoolSize(  vk::DescriptorType::eCombinedImageSampler, MAX_FRAMES_IN_FLIGHT * MAX_TEXTURES)
+			vk::DescriptorPoolSize( vk::DescriptorType::eStorageBuffer, MAX_FRAMES_IN_FLIGHT * 5)
 		};
 		vk::DescriptorPoolCreateInfo poolInfo{.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet, .maxSets = MAX_FRAMES_IN_FLIGHT, .poolSizeCount = poolSize.size(), .pPoolSizes = poolSize.data()};
 		_descriptorPool = vk::raii::DescriptorPool(_context.device(), poolInfo);
@@ -167,17 +253,7 @@ namespace Core::Rendering::Vulkan {
 
 		_descriptorSets = _context.device().allocateDescriptorSets(allocInfo);
 
-		std::vector<vk::DescriptorImageInfo> imageInfos(MAX_TEXTURES);
-
-	    // Fill all slots with dummy texture
-	    for (uint32_t i = 0; i < MAX_TEXTURES; ++i) {
-	        imageInfos[i] = vk::DescriptorImageInfo{
-	            _textureManager->get(0).sampler,
-	            _textureManager->get(0).view,
-	            vk::ImageLayout::eShaderReadOnlyOptimal
-	        };
-	    }
-
+		// Textures live in the bindless set, only the buffers are per frame
 	    for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
 		    vk::DescriptorBufferInfo bufferInfo{
 		    	.buffer = _uniformBuffers[frame],
@@ -185,68 +261,337 @@ namespace Core::Rendering::Vulkan {
 				.range = sizeof(UniformBufferObject)
 			};
 
-	    	std::array<vk::WriteDescriptorSet, 2> descriptorWrites{
-	    		vk::WriteDescriptorSet{
-	    			.dstSet = _descriptorSets[frame],
-					.dstBinding = 0,
-					.dstArrayElement = 0,
-					.descriptorCount = 1,
-					.descriptorType = vk::DescriptorType::eUniformBuffer,
-					.pBufferInfo = &bufferInfo
-				},
-				vk::WriteDescriptorSet{
-					.dstSet = _descriptorSets[frame],
-					.dstBinding = 1,
-					.dstArrayElement = 0,
-					.descriptorCount = MAX_TEXTURES,
-					.descriptorType = vk::DescriptorType::eCombinedImageSampler,
-					.pImageInfo = imageInfos.data()
-				}
+	    	vk::WriteDescriptorSet descriptorWrite{
+	    		.dstSet = _descriptorSets[frame],
+				.dstBinding = 0,
+				.dstArrayElement = 0,
+				.descriptorCount = 1,
+				.descriptorType = vk::DescriptorType::eUniformBuffer,
+				.pBufferInfo = &bufferInfo
 	    	};
 
-			_context.device().updateDescriptorSets(descriptorWrites, {});
+			_context.device().updateDescriptorSets(descriptorWrite, {});
+			writeDrawDescriptors(static_cast<uint32_t>(frame));
 	    }
 	}
 
-	void Renderer::updateTextureDescriptor(uint32_t textureIndex) {
-		for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
-			vk::DescriptorImageInfo imageInfo{
-				_textureManager->get(textureIndex).sampler,
-				_textureManager->get(textureIndex).view,
-				vk::ImageLayout::eShaderReadOnlyOptimal
-			};
+	void Renderer::updateUniformBuffer(uint32_t frameIndex) {
+		UniformBufferObject ubo{};
+		ubo.view = lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
 
-			vk::WriteDescriptorSet write{
-				.dstSet = _descriptorSets[frame],
-				.dstBinding = 1,
-				.dstArrayElement = textureIndex,
-				.descriptorCount = 1,
-				.descriptorType = vk::DescriptorType::eCombinedImageSampler,
-				.pImageInfo = &imageInfo
-			};
+		vk::Extent2D extent = _swapchain->extent();
 
-			_context.device().updateDescriptorSets(write, {});
+		ubo.proj = glm::perspective(glm::radians(45.0f), static_cast<float>(extent.width) / static_cast<float>(extent.height), 0.1f, 10.0f);
+
+		ubo.proj[1][1] *= -1;
+
+		memcpy(_uniformBuffersMapped[frameIndex], &ubo, sizeof(ubo));
+
+		// Gribb-Hartmann: planes are sums of the view-projection rows. The near plane uses the
+		// -w <= z convention, which contains the 0 <= z one, so it stays conservative for either depth range.
+		const glm::mat4 viewProj = ubo.proj * ubo.view;
+		const glm::vec4 row0{viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]};
+		const glm::vec4 row1{viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]};
+		const glm::vec4 row2{viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]};
+		const glm::vec4 row3{viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]};
+
+		_frustumPlanes = {row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2};
+		for (auto& plane : _frustumPlanes)
+			plane /= glm::length(glm::vec3(plane));
+
+		_cameraPosition = glm::vec3(glm::inverse(ubo.view)[3]);
+		_lodScale = std::abs(ubo.proj[1][1]) * 0.5f * static_cast<float>(extent.height);
+	}
+
+	void Renderer::buildDrawBatches() {
+		// Sort instances so the ones sharing a geometry page, a vertex format, an index type and a mesh are contiguous
+		// in the instance buffer, textures are indexed per instance and only order them within a batch
+		std::vector<uint32_t> order(_instances.size());
+		std::iota(order.begin(), order.end(), 0u);
+		std::ranges::stable_sort(order, [this](uint32_t a, uint32_t b) {
+			const auto& lhs = _instances[a];
+			const auto& rhs = _instances[b];
+			const auto& lhsMesh = _meshManager->get(lhs.meshID);
+			const auto& rhsMesh = _meshManager->get(rhs.meshID);
+			return std::tie(lhsMesh.page, lhsMesh.vertexFormat, lhsMesh.indexType, lhs.meshID, lhs.textureID) <
+			       std::tie(rhsMesh.page, rhsMesh.vertexFormat, rhsMesh.indexType, rhs.meshID, rhs.textureID);
+		});
+
+		_instanceData.clear();
+		_instanceData.reserve(_instances.size());
+		_drawBatches.clear();
+		_instanceBounds.clear();
+		_instanceBounds.reserve(_instances.size());
+		_instanceScales.clear();
+		_instanceScales.reserve(_instances.size());
+
+		// Instances point at the entry of their mesh's finest level once the entries are laid out, culling picks
+		// the level
+		for (uint32_t index : order) {
+			const auto& instance = _instances[index];
+			const auto& mesh = _meshManager->get(instance.meshID);
+
+			if (_drawBatches.empty() || _drawBatches.back().meshID != instance.meshID)
+				_drawBatches.push_back({instance.meshID, static_cast<uint32_t>(_instanceData.size()), 0, 0});
+
+			// Instances of a destroyed texture sample the dummy one
+			const TextureID textureID = _textureManager->contains(instance.textureID) ? instance.textureID : 0;
+
+			_drawBatches.back().instanceCount++;
+			_instanceData.push_back({
+				instance.transform,
+				textureID,
+				0,
+				_textureManager->get(textureID).samplerIndex,
+				0
+			});
+
+			// Same transform as the culling shader: moved center, radius scaled by the largest axis scale
+			const glm::vec4 sphere = mesh.boundingSphere;
+			const glm::mat4& transform = instance.transform;
+			const float scale = std::max({glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))});
+			_instanceBounds.push(glm::vec3(transform * glm::vec4(glm::vec3(sphere), 1.0f)), sphere.w * scale);
+			_instanceScales.push_back(scale);
 		}
+
+		// One indirect command slot per level and culled meshlet of each batch, grouped by the page whose buffers it
+		// reads, the pipeline decoding its vertices and the type its index buffer is bound with. Every entry owns a
+		// range of the visible list as large as its batch, any instance may select it.
+		_cullBatches.clear();
+		_drawGroups.clear();
+		_visibleInstanceCapacity = 0;
+		uint32_t clusterSlots = 0;
+
+		for (auto& batch : _drawBatches) {
+			const auto& mesh = _meshManager->get(batch.meshID);
+
+			batch.firstCullBatch = static_cast<uint32_t>(_cullBatches.size());
+			for (uint32_t i = batch.firstInstance; i < batch.firstInstance + batch.instanceCount; i++)
+				_instanceData[i].batchIndex = batch.firstCullBatch;
+
+			// Meshes with enough meshlets are culled cluster by cluster at their finest level, as long as their
+			// ranges fit in what is left of the budget. The others are culled as whole levels.
+			const uint64_t batchClusterSlots = static_cast<uint64_t>(mesh.meshletCount) * batch.instanceCount;
+			const bool clustered = mesh.meshletCount >= MIN_CULLED_CLUSTERS && clusterSlots + batchClusterSlots <= MAX_CLUSTER_SLOTS;
+			const uint32_t clusterCount = clustered ? mesh.meshletCount : 0;
+			const std::span<const Meshlet> meshlets = _meshManager->meshlets(mesh).first(clusterCount);
+			if (clustered)
+				clusterSlots += static_cast<uint32_t>(batchClusterSlots);
+
+			// Levels first, then the meshlets partitioning the finest level
+			for (uint32_t entry = 0; entry < mesh.lodCount + clusterCount; entry++) {
+				if (_drawGroups.empty() || _drawGroups.back().page != mesh.page || _drawGroups.back().vertexFormat != mesh.vertexFormat ||
+				    _drawGroups.back().indexType != mesh.indexType || _drawGroups.back().commandCount == _maxDrawIndirectCount)
+					_drawGroups.push_back({mesh.page, mesh.vertexFormat, mesh.indexType, static_cast<uint32_t>(_cullBatches.size()), 0});
+				_drawGroups.back().commandCount++;
+
+				CullBatch cullBatch{
+					.boundingSphere = mesh.boundingSphere,
+					.indexCount = 0,
+					.firstIndex = 0,
+					.vertexOffset = mesh.vertexOffset,
+					.firstInstance = _visibleInstanceCapacity,
+					.group = static_cast<uint32_t>(_drawGroups.size() - 1),
+					.groupFirstCommand = _drawGroups.back().firstCommand,
+					.lodError = 0.0f,
+					.lodCount = mesh.lodCount,
+					.positionOffset = glm::vec4(mesh.positionOffset, 0.0f),
+					.positionScale = glm::vec4(mesh.positionScale, 0.0f),
+					.cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+					.clusterCount = entry == 0 ? clusterCount : 0,
+					.padding = {}
+				};
+				if (entry < mesh.lodCount) {
+					cullBatch.indexCount = mesh.lods[entry].indexCount;
+					cullBatch.firstIndex = mesh.lods[entry].firstIndex;
+					cullBatch.lodError = mesh.lods[entry].error;
+				} else {
+					const Meshlet& meshlet = meshlets[entry - mesh.lodCount];
+					cullBatch.boundingSphere = meshlet.boundingSphere;
+					cullBatch.indexCount = meshlet.triangleCount * 3;
+					cullBatch.firstIndex = meshlet.firstIndex;
+					cullBatch.cone = meshlet.cone;
+				}
+				_cullBatches.push_back(cullBatch);
+
+				// The finest level of a clustered mesh is never selected whole
+				if (entry != 0 || clusterCount == 0)
+					_visibleInstanceCapacity += batch.instanceCount;
+			}
+		}
+
+		_instanceVersion++;
 	}
 
-	void Renderer::updateUniformBuffer(uint32_t frameIndex) {
-		static auto startTime = std::chrono::high_resolution_clock::now();
+	void Renderer::updateDrawBuffers(uint32_t frameIndex) {
+		if (_instancesDirty) {
+			buildDrawBatches();
+			_instancesDirty = false;
+		}
 
-		auto currentTime = std::chrono::high_resolution_clock::now();
-		float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+		if (_drawBuffersVersion[frameIndex] == _instanceVersion)
+			return;
 
-		UniformBufferObject ubo{};
-		ubo.model = rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+		const auto instanceCount = static_cast<vk::DeviceSize>(_instanceData.size());
+		const auto batchCount = static_cast<vk::DeviceSize>(_cullBatches.size());
+		const auto groupCount = static_cast<vk::DeviceSize>(_drawGroups.size());
+
+		const vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+		const vk::MemoryPropertyFlags cullOutput = _cpuCulling ? hostVisible : vk::MemoryPropertyFlagBits::eDeviceLocal;
+		bool resized = false;
+		resized |= reserveBuffer(_instanceBuffers[frameIndex], instanceCount * sizeof(InstanceData), vk::BufferUsageFlagBits::eStorageBuffer, hostVisible);
+		resized |= reserveBuffer(_cullBatchBuffers[frameIndex], batchCount * sizeof(CullBatch), vk::BufferUsageFlagBits::eStorageBuffer, hostVisible);
+		resized |= reserveBuffer(_visibleInstanceBuffers[frameIndex], _visibleInstanceCapacity * sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer,
+		                         cullOutput);
+		resized |= reserveBuffer(_drawCommandBuffers[frameIndex], batchCount * sizeof(vk::DrawIndexedIndirectCommand),
+		                         vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer, cullOutput);
+		resized |= reserveBuffer(_drawCountBuffers[frameIndex], (groupCount + batchCount) * sizeof(uint32_t),
+		                         vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+		                         cullOutput);
+		if (resized)
+			writeDrawDescriptors(frameIndex);
+
+		memcpy(_instanceBuffers[frameIndex].memory.mapped(), _instanceData.data(), instanceCount * sizeof(InstanceData));
+		memcpy(_cullBatchBuffers[frameIndex].memory.mapped(), _cullBatches.data(), batchCount * sizeof(CullBatch));
+		_drawBuffersVersion[frameIndex] = _instanceVersion;
+	}
 
-		ubo.view = lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	uint32_t Renderer::selectLod(const CullBatch* levels, const glm::vec3& center, float radius, float scale) const {
+		// Nearest point of the bounding sphere, clamped so instances around the camera keep the finest level
+		const float distance = std::max(glm::length(center - _cameraPosition) - radius, 1e-3f);
+		const float pixelsPerUnit = scale * _lodScale / distance;
 
-		vk::Extent2D extent = _swapchain->extent();
+		// Errors grow with the level, keep the last one that stays under the threshold
+		uint32_t lod = 0;
+		while (lod + 1 < levels[0].lodCount && levels[lod + 1].lodError * pixelsPerUnit <= LOD_ERROR_PIXELS)
+			lod++;
+		return lod;
+	}
 
-		ubo.proj = glm::perspective(glm::radians(45.0f), static_cast<float>(extent.width) / static_cast<float>(extent.height), 0.1f, 10.0f);
+	void Renderer::cullOnCpu(uint32_t frameIndex) {
+		_visibleInstances.resize(_instanceBounds.size());
+		const uint32_t visibleCount = cullSpheres(_instanceBounds, _frustumPlanes, _visibleInstances.data());
+
+		auto* visible = static_cast<uint32_t*>(_visibleInstanceBuffers[frameIndex].memory.mapped());
+		auto* commands = static_cast<vk::DrawIndexedIndirectCommand*>(_drawCommandBuffers[frameIndex].memory.mapped());
+		_groupDrawCounts.assign(_drawGroups.size(), 0);
+
+		// Visible indices are ascending and instances are sorted by batch, so each batch's visible instances are
+		// contiguous. Each is appended to the range of the level it selects, or of every meshlet it sees.
+		uint32_t cursor = 0;
+		for (const auto& drawBatch : _drawBatches) {
+			const CullBatch* levels = &_cullBatches[drawBatch.firstCullBatch];
+			const uint32_t entryCount = levels[0].lodCount + levels[0].clusterCount;
+			const uint32_t end = drawBatch.firstInstance + drawBatch.instanceCount;
+
+			_entryInstanceCounts.assign(entryCount, 0);
+			for (; cursor < visibleCount && _visibleInstances[cursor] < end; cursor++) {
+				const uint32_t instance = _visibleInstances[cursor];
+				const glm::vec3 center(_instanceBounds.centerX()[instance], _instanceBounds.centerY()[instance], _instanceBounds.centerZ()[instance]);
+				const uint32_t lod = selectLod(levels, center, _instanceBounds.radius()[instance], _instanceScales[instance]);
+				if (lod == 0 && levels[0].clusterCount > 0)
+					cullClustersOnCpu(instance, levels, visible, _entryInstanceCounts.data());
+				else
+					visible[levels[lod].firstInstance + _entryInstanceCounts[lod]++] = instance;
+			}
 
-		ubo.proj[1][1] *= -1;
+			for (uint32_t entry = 0; entry < entryCount; entry++) {
+				if (_entryInstanceCounts[entry] == 0)
+					continue;
+
+				const auto& batch = levels[entry];
+				commands[batch.groupFirstCommand + _groupDrawCounts[batch.group]++] = vk::DrawIndexedIndirectCommand{
+					.indexCount = batch.indexCount,
+					.instanceCount = _entryInstanceCounts[entry],
+					.firstIndex = batch.firstIndex,
+					.vertexOffset = batch.vertexOffset,
+					.firstInstance = batch.firstInstance
+				};
+			}
+		}
 
-		memcpy(_uniformBuffersMapped[frameIndex], &ubo, sizeof(ubo));
+		// Mapped memory may be write-combined, counts are accumulated on the side and written once
+		memcpy(_drawCountBuffers[frameIndex].memory.mapped(), _groupDrawCounts.data(), _groupDrawCounts.size() * sizeof(uint32_t));
+	}
+
+	void Renderer::cullClustersOnCpu(uint32_t instance, const CullBatch* levels, uint32_t* visible, uint32_t* entryInstanceCounts) const {
+		const glm::mat4& model = _instanceData[instance].model;
+		const float scale = _instanceScales[instance];
+		glm::mat3 cofactor;
+		const bool coneCulling = coneTransform(model, cofactor);
+
+		// Same tests as cullClusters in the shader
+		for (uint32_t entry = levels[0].lodCount; entry < levels[0].lodCount + levels[0].clusterCount; entry++) {
+			const CullBatch& cluster = levels[entry];
+			const glm::vec3 center(model * glm::vec4(glm::vec3(cluster.boundingSphere), 1.0f));
+			const float radius = cluster.boundingSphere.w * scale;
+			if (!isSphereVisible(_frustumPlanes, center, radius))
+				continue;
+
+			if (coneCulling) {
+				const glm::vec3 axis = glm::normalize(cofactor * glm::vec3(cluster.cone));
+				if (isConeBackfacing(glm::vec4(axis, cluster.cone.w), center, radius, _cameraPosition))
+					continue;
+			}
+
+			visible[cluster.firstInstance + entryInstanceCounts[entry]++] = instance;
+		}
+	}
+
+	void Renderer::recordCulling(const vk::raii::CommandBuffer& commandBuffer) {
+		const vk::Buffer drawCounts = *_drawCountBuffers[_frameIndex].buffer;
+
+		// Counters are accumulated with atomics, start every frame from zero
+		commandBuffer.fillBuffer(drawCounts, 0, vk::WholeSize, 0);
+
+		vk::MemoryBarrier2 clearBarrier{
+			.srcStageMask = vk::PipelineStageFlagBits2::eClear,
+			.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect,
+			.dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eIndirectCommandRead
+		};
+		commandBuffer.pipelineBarrier2(vk::DependencyInfo{.memoryBarrierCount = 1, .pMemoryBarriers = &clearBarrier});
+
+		if (_instanceData.empty())
+			return;
+
+		CullConstants constants{
+			.frustumPlanes = {},
+			.instanceCount = static_cast<uint32_t>(_instanceData.size()),
+			.batchCount = static_cast<uint32_t>(_cullBatches.size()),
+			.groupCount = static_cast<uint32_t>(_drawGroups.size()),
+			.lodScale = _lodScale,
+			.cameraPosition = glm::vec4(_cameraPosition, LOD_ERROR_PIXELS)
+		};
+		std::ranges::copy(_frustumPlanes, constants.frustumPlanes);
+
+		auto& layout = _pipelineManager->pipelineLayout();
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, layout, 0, *_descriptorSets[_frameIndex], nullptr);
+		commandBuffer.pushConstants<CullConstants>(layout, vk::ShaderStageFlagBits::eCompute, 0, constants);
+
+		// Pass 1: test every instance, append the visible ones to the range of the level they select
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *_pipelineManager->get("cullInstances"));
+		commandBuffer.dispatch((constants.instanceCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+
+		vk::MemoryBarrier2 cullBarrier{
+			.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+			.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+			.dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+		};
+		commandBuffer.pipelineBarrier2(vk::DependencyInfo{.memoryBarrierCount = 1, .pMemoryBarriers = &cullBarrier});
+
+		// Pass 2: compact the batches with visible instances into each group's indirect commands
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *_pipelineManager->get("compactDraws"));
+		commandBuffer.dispatch((constants.batchCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+
+		vk::MemoryBarrier2 drawBarrier{
+			.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+			.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eVertexShader,
+			.dstAccessMask = vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eShaderStorageRead
+		};
+		commandBuffer.pipelineBarrier2(vk::DependencyInfo{.memoryBarrierCount = 1, .pMemoryBarriers = &drawBarrier});
 	}
 
 	void Renderer::recordCommandBuffer(uint32_t imageIndex) {
@@ -255,6 +600,9 @@ namespace Core::Rendering::Vulkan {
 		vk::CommandBufferBeginInfo beginInfo{.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit};
 		commandBuffer.begin(beginInfo);
 
+		if (!_cpuCulling)
+			recordCulling(commandBuffer);
+
 		// Before starting rendering, transition the swapchain image to COLOR_ATTACHMENT_OPTIMAL
 		recordTransitionImageLayout(
 			_swapchain->images()[imageIndex],
@@ -304,30 +652,7 @@ namespace Core::Rendering::Vulkan {
 		};
 
 		commandBuffer.beginRendering(renderingInfo);
-
-		// Bind pipeline
-		auto& pipeline = *_pipelineManager->get("basic");
-		commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
-
-		commandBuffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f));
-		commandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
-
-		for (auto& instance : _instances) {
-			const auto& mesh = _meshManager->get(instance.meshID);
-
-			vk::Buffer vertexBuffers[] = {*mesh.vertexBuffer};
-			vk::DeviceSize offsets[] = {0};
-			commandBuffer.bindVertexBuffers(0, vertexBuffers, offsets);
-			commandBuffer.bindIndexBuffer(*mesh.indexBuffer, 0, vk::IndexType::eUint32);
-
-			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, _pipelineManager->pipelineLayout(), 0, *_descriptorSets[_frameIndex], nullptr);
-
-			const uint32_t textureValue = instance.textureID;
-			vk::ArrayProxy<const uint32_t> pushDataProxy(textureValue);
-			commandBuffer.pushConstants(*_pipelineManager->pipelineLayout(),vk::ShaderStageFlagBits::eFragment,0,pushDataProxy);
-
-			commandBuffer.drawIndexed(mesh.indexCount, 1, 0, 0, 0);
-		}
+		recordDraws(commandBuffer);
 		commandBuffer.endRendering();
 
 		// After rendering, transition the swapchain image to PRESENT_SRC
@@ -344,6 +669,51 @@ namespace Core::Rendering::Vulkan {
 		commandBuffer.end();
 	}
 
+	void Renderer::recordDraws(const vk::raii::CommandBuffer& commandBuffer) const {
+		const vk::Extent2D extent = _swapchain->extent();
+
+		commandBuffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f));
+		commandBuffer.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
+
+		const std::array descriptorSets = {*_descriptorSets[_frameIndex], _bindlessTable->set()};
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, _pipelineManager->pipelineLayout(), 0, descriptorSets, nullptr);
+
+		// One multi-draw per group, the culling passes wrote how many of its commands are used
+		const vk::Buffer drawCommands = *_drawCommandBuffers[_frameIndex].buffer;
+		const vk::Buffer drawCounts = *_drawCountBuffers[_frameIndex].buffer;
+		uint32_t boundPage = UINT32_MAX;
+		std::optional<VertexFormat> boundFormat;
+		std::optional<IndexType> boundIndexType;
+
+		for (uint32_t group = 0; group < _drawGroups.size(); group++) {
+			const auto& drawGroup = _drawGroups[group];
+
+			// Groups are sorted by format within a page, so pipelines switch at most once per format of a page
+			if (drawGroup.vertexFormat != boundFormat) {
+				commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics,
+				                           _pipelineManager->get("basic", PipelineConfig{.vertexFormat = drawGroup.vertexFormat}));
+				boundFormat = drawGroup.vertexFormat;
+			}
+
+			// firstIndex counts elements of the mesh's index type from the start of the page
+			if (drawGroup.page != boundPage || drawGroup.indexType != boundIndexType) {
+				const auto& page = _meshManager->page(drawGroup.page);
+				if (drawGroup.page != boundPage) {
+					vk::Buffer vertexBuffers[] = {*page.vertexBuffer};
+					vk::DeviceSize offsets[] = {0};
+					commandBuffer.bindVertexBuffers(0, vertexBuffers, offsets);
+				}
+				commandBuffer.bindIndexBuffer(*page.indexBuffer, 0, toVkIndexType(drawGroup.indexType));
+				boundPage = drawGroup.page;
+				boundIndexType = drawGroup.indexType;
+			}
+
+			commandBuffer.drawIndexedIndirectCount(drawCommands, drawGroup.firstCommand * sizeof(vk::DrawIndexedIndirectCommand),
+			                                       drawCounts, group * sizeof(uint32_t),
+			                                       drawGroup.commandCount, sizeof(vk::DrawIndexedIndirectCommand));
+		}
+	}
+
 	void Renderer::recordTransitionImageLayout(
 		vk::Image image,
 		vk::ImageLayout oldLayout,
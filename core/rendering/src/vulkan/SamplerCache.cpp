@@ -0,0 +1,67 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/rendering/vulkan/SamplerCache.hpp>
+#include <core/utils/Hash.hpp>
+
+#include <bit>
+
+namespace Core::Rendering::Vulkan {
+
+	size_t SamplerCache::KeyHash::operator()(const Key& key) const noexcept {
+		// Every member is 4 bytes wide, the key has no padding
+		static_assert(sizeof(Key) == 16 * sizeof(uint32_t));
+		return static_cast<size_t>(Utils::hashValue(key));
+	}
+
+	SamplerCache::SamplerCache(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device)
+		: _device(device), _maxSamplers(physicalDevice.getProperties().limits.maxSamplerAllocationCount) {}
+
+	SamplerCache::Key SamplerCache::makeKey(const vk::SamplerCreateInfo& info) {
+		return Key{
+			.flags = static_cast<VkSamplerCreateFlags>(info.flags),
+			.magFilter = info.magFilter,
+			.minFilter = info.minFilter,
+			.mipmapMode = info.mipmapMode,
+			.addressModeU = info.addressModeU,
+			.addressModeV = info.addressModeV,
+			.addressModeW = info.addressModeW,
+			.mipLodBias = std::bit_cast<uint32_t>(info.mipLodBias),
+			.anisotropyEnable = info.anisotropyEnable,
+			.maxAnisotropy = std::bit_cast<uint32_t>(info.maxAnisotropy),
+			.compareEnable = info.compareEnable,
+			.compareOp = info.compareOp,
+			.minLod = std::bit_cast<uint32_t>(info.minLod),
+			.maxLod = std::bit_cast<uint32_t>(info.maxLod),
+			.borderColor = info.borderColor,
+			.unnormalizedCoordinates = info.unnormalizedCoordinates
+		};
+	}
+
+	vk::Sampler SamplerCache::get(const vk::SamplerCreateInfo& info) {
+		if (info.pNext != nullptr)
+			throw std::runtime_error("sampler create info extension chains are not cached");
+
+		const Key key = makeKey(info);
+
+		std::scoped_lock lock(_mutex);
+
+		if (auto it = _samplers.find(key); it != _samplers.end()) {
+			_hits++;
+			return *it->second;
+		}
+
+		if (_samplers.size() >= _maxSamplers)
+			throw std::runtime_error("maxSamplerAllocationCount reached");
+
+		_misses++;
+		auto [it, inserted] = _samplers.emplace(key, vk::raii::Sampler(_device, info));
+		return *it->second;
+	}
+
+	SamplerCacheStats SamplerCache::stats() const {
+		std::scoped_lock lock(_mutex);
+		return {_hits, _misses, _samplers.size()};
+	}
+}
@@ -0,0 +1,74 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/rendering/vulkan/StagingRing.hpp>
+#include <core/rendering/vulkan/Context.hpp>
+
+namespace Core::Rendering::Vulkan {
+
+	static vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	StagingRing::StagingRing(Context &context, vk::DeviceSize capacity)
+		: _capacity(capacity) {
+		context.createBuffer(
+			capacity,
+			vk::BufferUsageFlagBits::eTransferSrc,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+			_buffer,
+			_memory
+		);
+	}
+
+	std::optional<vk::DeviceSize> StagingRing::allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+		if (size > _capacity)
+			return std::nullopt;
+
+		// Restart from the beginning whenever the ring drained completely
+		if (!_open && _fences.empty()) {
+			_head = 0;
+			_tail = 0;
+			_wrapped = false;
+		}
+
+		vk::DeviceSize offset = alignUp(_head, alignment);
+
+		if (!_wrapped) {
+			// Free space is [head, capacity) then [0, tail)
+			if (offset + size > _capacity) {
+				if (size > _tail)
+					return std::nullopt;
+				offset = 0;
+				_wrapped = true;
+			}
+		} else if (offset + size > _tail) {
+			// Free space is [head, tail)
+			return std::nullopt;
+		}
+
+		_head = offset + size;
+		_open = true;
+		return offset;
+	}
+
+	void StagingRing::close(uint64_t timelineValue) {
+		if (!_open)
+			return;
+
+		_fences.push_back({_head, timelineValue});
+		_open = false;
+	}
+
+	void StagingRing::reclaim(uint64_t completedValue) {
+		while (!_fences.empty() && _fences.front().timelineValue <= completedValue) {
+			const vk::DeviceSize end = _fences.front().end;
+			// Tail catching up past the end of the buffer means it wrapped as well
+			if (end < _tail)
+				_wrapped = false;
+			_tail = end;
+			_fences.pop_front();
+		}
+	}
+}
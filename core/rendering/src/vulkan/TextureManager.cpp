@@ -3,10 +3,33 @@
 //
 
 #include <core/rendering/vulkan/TextureManager.hpp>
+#include <core/utils/ImageUtils.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
 
 namespace Core::Rendering::Vulkan {
-	TextureManager::TextureManager(Context& context)
-		: _context(context) {
+	static vk::Format toVkFormat(TextureFormat format) {
+		switch (format) {
+			case TextureFormat::BC1Srgb: return vk::Format::eBc1RgbSrgbBlock;
+			case TextureFormat::BC3Srgb: return vk::Format::eBc3SrgbBlock;
+			case TextureFormat::BC5Unorm: return vk::Format::eBc5UnormBlock;
+			case TextureFormat::BC7Srgb: return vk::Format::eBc7SrgbBlock;
+			default: return vk::Format::eR8G8B8A8Srgb;
+		}
+	}
+
+	TextureManager::TextureManager(Context& context, BindlessTable& bindlessTable)
+		: _context(context), _bindlessTable(bindlessTable) {
+		constexpr vk::FormatFeatureFlags blitFeatures = vk::FormatFeatureFlagBits::eBlitSrc |
+		                                                vk::FormatFeatureFlagBits::eBlitDst |
+		                                                vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+		const vk::FormatProperties properties = _context.physicalDevice().getFormatProperties(vk::Format::eR8G8B8A8Srgb);
+		_linearBlit = (properties.optimalTilingFeatures & blitFeatures) == blitFeatures;
+
+		std::cout << "[ASTRO CORE] [VULKAN] [TEXTURE] mip chains generated on the " << (_linearBlit ? "GPU" : "CPU") << std::endl;
+
 		createDummyTexture();
 	}
 
@@ -14,41 +37,112 @@ namespace Core::Rendering::Vulkan {
 
 		Texture texture;
 
-		_context.createTextureImageFromData(textureData.pixels.data(), textureData.width, textureData.height, texture.image, texture.memory);
+		uint32_t mipLevels = 1;
+		texture.ready = createImage(textureData, texture, mipLevels);
+
+		texture.view = _context.createImageView(texture.image, toVkFormat(textureData.format), vk::ImageAspectFlagBits::eColor, mipLevels);
 
-		texture.view = _context.createImageView(texture.image, vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor);
+		texture.samplerIndex = samplerIndex(_context.textureSamplerInfo());
 
-		texture.sampler = _context.createTextureSampler();
+		return addTexture(std::move(texture));
+	}
 
-		_textures.push_back(std::move(texture));
+	void TextureManager::destroyTexture(TextureID id) {
+		if (id == 0)
+			throw std::runtime_error("the dummy texture cannot be destroyed");
+		if (!contains(id))
+			throw std::runtime_error("destroying an unknown texture");
 
-		return static_cast<TextureID>(_textures.size() - 1);
+		_retired.push_back({id, std::move(_textures[id]), _frameNumber});
+		_textures[id] = Texture{};
 	}
 
+	void TextureManager::beginFrame(uint64_t frameNumber) {
+		_frameNumber = frameNumber;
+
+		// Frames complete in order, so does the retirement queue
+		while (!_retired.empty() && _retired.front().frame + MAX_FRAMES_IN_FLIGHT <= frameNumber) {
+			_bindlessTable.removeTexture(_retired.front().id);
+			_retired.pop_front();
+		}
+	}
 
 	TextureID TextureManager::createDummyTexture() {
 		assert(_textures.empty() && "Dummy texture must be created first!");
 
-		Texture texture;
-
-		// 1x1 white pixel RGBA
-		uint8_t pixel[4] = { 255, 255, 255, 255 };
-		uint32_t width = 1;
-		uint32_t height = 1;
+		// 1x1 white pixel RGBA, takes the first bindless slot so its id is 0
+		return loadTexture(TextureData{.pixels = {255, 255, 255, 255}, .width = 1, .height = 1, .nbChannels = 4});
+	}
 
-		// Create Vulkan image and allocate memory
-		_context.createTextureImageFromData(pixel, width, height, texture.image, texture.memory);
+	TextureID TextureManager::addTexture(Texture&& texture) {
+		const uint32_t slot = _bindlessTable.addTexture(*texture.view);
 
-		// Create image view
-		texture.view = _context.createImageView(texture.image, vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor);
+		if (slot >= _textures.size())
+			_textures.resize(slot + 1);
+		_textures[slot] = std::move(texture);
 
-		// Create sampler
-		texture.sampler = _context.createTextureSampler();
+		return static_cast<TextureID>(slot);
+	}
 
-		// Add to texture vector
-		_textures.push_back(std::move(texture));
+	uint32_t TextureManager::samplerIndex(const vk::SamplerCreateInfo& info) {
+		// Equal create infos return the same handle, which the bindless table maps to the same slot
+		return _bindlessTable.addSampler(_context.samplers().get(info));
+	}
 
-		// Return the index
-		return static_cast<TextureID>(_textures.size() - 1);
+	UploadTicket TextureManager::createImage(const TextureData& textureData, Texture& texture, uint32_t& mipLevels) {
+		const TextureData* source = &textureData;
+		TextureData cpuChain;
+
+		const bool compressed = Utils::isBlockCompressed(textureData.format);
+		if (compressed && !_context.supportsTextureCompressionBC())
+			throw std::runtime_error("block compressed texture on a device without textureCompressionBC");
+
+		// Compressed levels cannot be blitted, they are uploaded as provided
+		if (textureData.mipLevels > 1 || compressed) {
+			mipLevels = textureData.mipLevels;
+			if (mipLevels > Utils::mipLevelCount(textureData.width, textureData.height))
+				throw std::runtime_error("texture has more mip levels than its size allows");
+		} else {
+			mipLevels = Utils::mipLevelCount(textureData.width, textureData.height);
+			if (!_linearBlit && mipLevels > 1) {
+				cpuChain = textureData;
+				Utils::generateMipChain(cpuChain);
+				source = &cpuChain;
+			}
+		}
+
+		// Levels provided by the source. They are staged as the one range spanning all of them, so data read
+		// straight from a mapped file goes to staging memory in a single copy whatever the level order.
+		std::vector<Uploader::ImageLevel> levels;
+		size_t begin = SIZE_MAX;
+		size_t end = 0;
+		for (uint32_t level = 0; level < source->mipLevels; level++) {
+			const uint32_t width = std::max(textureData.width >> level, 1u);
+			const uint32_t height = std::max(textureData.height >> level, 1u);
+			const size_t offset = Utils::mipLevelOffset(*source, level);
+			levels.push_back({.offset = offset, .width = width, .height = height});
+			begin = std::min(begin, offset);
+			end = std::max(end, offset + Utils::mipLevelSize(textureData.format, width, height));
+		}
+		for (Uploader::ImageLevel& level : levels)
+			level.offset -= begin;
+
+		vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+		if (levels.size() < mipLevels)
+			usage |= vk::ImageUsageFlagBits::eTransferSrc;
+
+		_context.createImage(
+			textureData.width,
+			textureData.height,
+			toVkFormat(textureData.format),
+			vk::ImageTiling::eOptimal,
+			usage,
+			vk::MemoryPropertyFlagBits::eDeviceLocal,
+			texture.image,
+			texture.memory,
+			mipLevels
+		);
+
+		return _context.uploader().uploadImage(source->data().data() + begin, end - begin, *texture.image, levels, mipLevels);
 	}
 }
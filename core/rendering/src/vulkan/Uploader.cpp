@@ -0,0 +1,376 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/rendering/vulkan/Uploader.hpp>
+#include <core/rendering/vulkan/Context.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace Core::Rendering::Vulkan {
+
+	Uploader::Uploader(Context &context)
+		: _context(context), _dedicatedTransfer(context.transferQueueFamily() != context.graphicsQueueFamily()),
+		  _stagingRing(context) {
+		auto &device = _context.device();
+
+		// Buffer to image copies need texel aligned offsets, 16 covers every format we upload
+		_stagingAlignment = std::max<vk::DeviceSize>(16, _context.physicalDevice().getProperties().limits.optimalBufferCopyOffsetAlignment);
+
+		_transferPool = vk::raii::CommandPool(device, vk::CommandPoolCreateInfo{
+			.flags = vk::CommandPoolCreateFlagBits::eTransient,
+			.queueFamilyIndex = _context.transferQueueFamily()});
+
+		if (_dedicatedTransfer)
+			_graphicsPool = vk::raii::CommandPool(device, vk::CommandPoolCreateInfo{
+				.flags = vk::CommandPoolCreateFlagBits::eTransient,
+				.queueFamilyIndex = _context.graphicsQueueFamily()});
+
+		vk::SemaphoreTypeCreateInfo timelineInfo{.semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0};
+		_timeline = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{.pNext = &timelineInfo});
+	}
+
+	Uploader::~Uploader() {
+		if (_timelineValue > 0)
+			wait(_timelineValue);
+	}
+
+	UploadTicket Uploader::uploadBuffer(const void *data, vk::DeviceSize size, vk::Buffer dstBuffer, vk::DeviceSize dstOffset) {
+		Batch &batch = currentBatch();
+
+		const StagingRange staging = stage(batch, data, size);
+		batch.transferCommands.copyBuffer(staging.buffer, dstBuffer, vk::BufferCopy{.srcOffset = staging.offset, .dstOffset = dstOffset, .size = size});
+
+		vk::BufferMemoryBarrier2 barrier{
+			.srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+			.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+			.dstAccessMask = vk::AccessFlagBits2::eMemoryRead,
+			.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.buffer = dstBuffer,
+			.offset = dstOffset,
+			.size = size
+		};
+
+		if (_dedicatedTransfer) {
+			barrier.srcQueueFamilyIndex = _context.transferQueueFamily();
+			barrier.dstQueueFamilyIndex = _context.graphicsQueueFamily();
+
+			// Release on the transfer queue, acquire on the graphics queue
+			vk::BufferMemoryBarrier2 acquire = barrier;
+			acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+			acquire.srcAccessMask = vk::AccessFlagBits2::eNone;
+			barrier.dstStageMask = vk::PipelineStageFlagBits2::eNone;
+			barrier.dstAccessMask = vk::AccessFlagBits2::eNone;
+			batch.bufferAcquires.push_back(acquire);
+		}
+		batch.bufferReleases.push_back(barrier);
+
+		return batch.ticket;
+	}
+
+	UploadTicket Uploader::uploadImage(const void *data, vk::DeviceSize size, vk::Image dstImage, uint32_t width, uint32_t height) {
+		const ImageLevel level{.offset = 0, .width = width, .height = height};
+		return uploadImage(data, size, dstImage, std::span(&level, 1), 1);
+	}
+
+	UploadTicket Uploader::uploadImage(const void *data, vk::DeviceSize size, vk::Image dstImage,
+	                                   std::span<const ImageLevel> levels, uint32_t mipLevels) {
+		assert(!levels.empty() && levels.size() <= mipLevels);
+		Batch &batch = currentBatch();
+
+		const StagingRange staging = stage(batch, data, size);
+
+		const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor, 0, mipLevels, 0, 1};
+		vk::ImageMemoryBarrier2 toTransfer{
+			.srcStageMask = vk::PipelineStageFlagBits2::eNone,
+			.srcAccessMask = vk::AccessFlagBits2::eNone,
+			.dstStageMask = vk::PipelineStageFlagBits2::eCopy,
+			.dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.oldLayout = vk::ImageLayout::eUndefined,
+			.newLayout = vk::ImageLayout::eTransferDstOptimal,
+			.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.image = dstImage,
+			.subresourceRange = range
+		};
+		batch.transferCommands.pipelineBarrier2(vk::DependencyInfo{.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toTransfer});
+
+		std::vector<vk::BufferImageCopy> regions;
+		regions.reserve(levels.size());
+		for (uint32_t level = 0; level < levels.size(); level++) {
+			regions.push_back(vk::BufferImageCopy{
+				.bufferOffset = staging.offset + levels[level].offset,
+				.bufferRowLength = 0,
+				.bufferImageHeight = 0,
+				.imageSubresource = {vk::ImageAspectFlagBits::eColor, level, 0, 1},
+				.imageOffset = {0, 0, 0},
+				.imageExtent = {levels[level].width, levels[level].height, 1}
+			});
+		}
+		batch.transferCommands.copyBufferToImage(staging.buffer, dstImage, vk::ImageLayout::eTransferDstOptimal, regions);
+
+		const auto copiedLevels = static_cast<uint32_t>(levels.size());
+		if (copiedLevels < mipLevels) {
+			const MipChain chain{
+				.image = dstImage,
+				.sourceLevel = copiedLevels - 1,
+				.sourceWidth = levels.back().width,
+				.sourceHeight = levels.back().height,
+				.mipLevels = mipLevels
+			};
+
+			// Without a dedicated family the transfer queue is the graphics one and can blit right away
+			if (!_dedicatedTransfer) {
+				recordMipChain(batch.transferCommands, chain);
+				return batch.ticket;
+			}
+
+			// Blits need the graphics queue: hand the image over in transfer layout, it finishes there
+			vk::ImageMemoryBarrier2 release{
+				.srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+				.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+				.dstStageMask = vk::PipelineStageFlagBits2::eNone,
+				.dstAccessMask = vk::AccessFlagBits2::eNone,
+				.oldLayout = vk::ImageLayout::eTransferDstOptimal,
+				.newLayout = vk::ImageLayout::eTransferDstOptimal,
+				.srcQueueFamilyIndex = _context.transferQueueFamily(),
+				.dstQueueFamilyIndex = _context.graphicsQueueFamily(),
+				.image = dstImage,
+				.subresourceRange = range
+			};
+			vk::ImageMemoryBarrier2 acquire = release;
+			acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+			acquire.srcAccessMask = vk::AccessFlagBits2::eNone;
+			acquire.dstStageMask = vk::PipelineStageFlagBits2::eBlit;
+			acquire.dstAccessMask = vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite;
+
+			batch.imageReleases.push_back(release);
+			batch.imageAcquires.push_back(acquire);
+			batch.mipChains.push_back(chain);
+			return batch.ticket;
+		}
+
+		vk::ImageMemoryBarrier2 toShader{
+			.srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+			.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eFragmentShader,
+			.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+			.oldLayout = vk::ImageLayout::eTransferDstOptimal,
+			.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+			.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.image = dstImage,
+			.subresourceRange = range
+		};
+
+		if (_dedicatedTransfer) {
+			toShader.srcQueueFamilyIndex = _context.transferQueueFamily();
+			toShader.dstQueueFamilyIndex = _context.graphicsQueueFamily();
+
+			vk::ImageMemoryBarrier2 acquire = toShader;
+			acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+			acquire.srcAccessMask = vk::AccessFlagBits2::eNone;
+			toShader.dstStageMask = vk::PipelineStageFlagBits2::eNone;
+			toShader.dstAccessMask = vk::AccessFlagBits2::eNone;
+			batch.imageAcquires.push_back(acquire);
+		}
+		batch.imageReleases.push_back(toShader);
+
+		return batch.ticket;
+	}
+
+	void Uploader::recordMipChain(const vk::raii::CommandBuffer &commands, const MipChain &chain) {
+		vk::ImageMemoryBarrier2 barrier{
+			.srcStageMask = vk::PipelineStageFlagBits2::eCopy | vk::PipelineStageFlagBits2::eBlit,
+			.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eBlit,
+			.dstAccessMask = vk::AccessFlagBits2::eTransferRead,
+			.oldLayout = vk::ImageLayout::eTransferDstOptimal,
+			.newLayout = vk::ImageLayout::eTransferSrcOptimal,
+			.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+			.image = chain.image,
+			.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}
+		};
+
+		auto width = static_cast<int32_t>(chain.sourceWidth);
+		auto height = static_cast<int32_t>(chain.sourceHeight);
+
+		// Each level is read once written: make the previous one a blit source, then halve it into the next
+		for (uint32_t level = chain.sourceLevel + 1; level < chain.mipLevels; level++) {
+			barrier.subresourceRange.baseMipLevel = level - 1;
+			commands.pipelineBarrier2(vk::DependencyInfo{.imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &barrier});
+
+			const int32_t nextWidth = std::max(width / 2, 1);
+			const int32_t nextHeight = std::max(height / 2, 1);
+			vk::ImageBlit blit{
+				.srcSubresource = {vk::ImageAspectFlagBits::eColor, level - 1, 0, 1},
+				.srcOffsets = std::array{vk::Offset3D{0, 0, 0}, vk::Offset3D{width, height, 1}},
+				.dstSubresource = {vk::ImageAspectFlagBits::eColor, level, 0, 1},
+				.dstOffsets = std::array{vk::Offset3D{0, 0, 0}, vk::Offset3D{nextWidth, nextHeight, 1}}
+			};
+			commands.blitImage(chain.image, vk::ImageLayout::eTransferSrcOptimal, chain.image, vk::ImageLayout::eTransferDstOptimal,
+			                   blit, vk::Filter::eLinear);
+
+			width = nextWidth;
+			height = nextHeight;
+		}
+
+		// Copied levels and the last one are still transfer destinations, the levels in between blit sources
+		std::vector<vk::ImageMemoryBarrier2> toShader;
+		auto transition = [&](uint32_t baseLevel, uint32_t levelCount, vk::ImageLayout layout) {
+			if (levelCount == 0)
+				return;
+			toShader.push_back(vk::ImageMemoryBarrier2{
+				.srcStageMask = vk::PipelineStageFlagBits2::eCopy | vk::PipelineStageFlagBits2::eBlit,
+				.srcAccessMask = vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eTransferRead,
+				.dstStageMask = vk::PipelineStageFlagBits2::eFragmentShader,
+				.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+				.oldLayout = layout,
+				.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+				.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+				.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+				.image = chain.image,
+				.subresourceRange = {vk::ImageAspectFlagBits::eColor, baseLevel, levelCount, 0, 1}
+			});
+		};
+		transition(0, chain.sourceLevel, vk::ImageLayout::eTransferDstOptimal);
+		transition(chain.sourceLevel, chain.mipLevels - 1 - chain.sourceLevel, vk::ImageLayout::eTransferSrcOptimal);
+		transition(chain.mipLevels - 1, 1, vk::ImageLayout::eTransferDstOptimal);
+
+		commands.pipelineBarrier2(vk::DependencyInfo{
+			.imageMemoryBarrierCount = static_cast<uint32_t>(toShader.size()),
+			.pImageMemoryBarriers = toShader.data()
+		});
+	}
+
+	void Uploader::flush() {
+		if (!_recording) {
+			collect();
+			return;
+		}
+
+		Batch &batch = *_recording;
+
+		batch.transferCommands.pipelineBarrier2(vk::DependencyInfo{
+			.bufferMemoryBarrierCount = static_cast<uint32_t>(batch.bufferReleases.size()),
+			.pBufferMemoryBarriers = batch.bufferReleases.data(),
+			.imageMemoryBarrierCount = static_cast<uint32_t>(batch.imageReleases.size()),
+			.pImageMemoryBarriers = batch.imageReleases.data()
+		});
+		batch.transferCommands.end();
+
+		const uint64_t copyValue = _dedicatedTransfer ? batch.ticket - 1 : batch.ticket;
+
+		vk::CommandBufferSubmitInfo transferInfo{.commandBuffer = *batch.transferCommands};
+		vk::SemaphoreSubmitInfo copyDone{.semaphore = *_timeline, .value = copyValue, .stageMask = vk::PipelineStageFlagBits2::eAllCommands};
+		_context.transferQueue().submit2(vk::SubmitInfo2{
+			.commandBufferInfoCount = 1,
+			.pCommandBufferInfos = &transferInfo,
+			.signalSemaphoreInfoCount = 1,
+			.pSignalSemaphoreInfos = &copyDone
+		});
+
+		if (_dedicatedTransfer) {
+			vk::CommandBufferAllocateInfo allocInfo{.commandPool = _graphicsPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1};
+			batch.graphicsCommands = std::move(_context.device().allocateCommandBuffers(allocInfo).front());
+			batch.graphicsCommands.begin(vk::CommandBufferBeginInfo{.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+			batch.graphicsCommands.pipelineBarrier2(vk::DependencyInfo{
+				.bufferMemoryBarrierCount = static_cast<uint32_t>(batch.bufferAcquires.size()),
+				.pBufferMemoryBarriers = batch.bufferAcquires.data(),
+				.imageMemoryBarrierCount = static_cast<uint32_t>(batch.imageAcquires.size()),
+				.pImageMemoryBarriers = batch.imageAcquires.data()
+			});
+			for (const MipChain &chain : batch.mipChains)
+				recordMipChain(batch.graphicsCommands, chain);
+			batch.graphicsCommands.end();
+
+			vk::CommandBufferSubmitInfo graphicsInfo{.commandBuffer = *batch.graphicsCommands};
+			vk::SemaphoreSubmitInfo acquireDone{.semaphore = *_timeline, .value = batch.ticket, .stageMask = vk::PipelineStageFlagBits2::eAllCommands};
+			_context.graphicsQueue().submit2(vk::SubmitInfo2{
+				.waitSemaphoreInfoCount = 1,
+				.pWaitSemaphoreInfos = &copyDone,
+				.commandBufferInfoCount = 1,
+				.pCommandBufferInfos = &graphicsInfo,
+				.signalSemaphoreInfoCount = 1,
+				.pSignalSemaphoreInfos = &acquireDone
+			});
+		}
+
+		_stagingRing.close(batch.ticket);
+		_timelineValue = batch.ticket;
+		_inFlight.push_back(std::move(batch));
+		_recording.reset();
+
+		collect();
+	}
+
+	bool Uploader::isComplete(UploadTicket ticket) const {
+		if (ticket == 0)
+			return true;
+		if (ticket > _timelineValue)
+			return false;
+		return _timeline.getCounterValue() >= ticket;
+	}
+
+	void Uploader::wait(UploadTicket ticket) const {
+		if (ticket == 0)
+			return;
+		if (ticket > _timelineValue)
+			throw std::runtime_error("waiting on an upload that was never flushed");
+
+		vk::SemaphoreWaitInfo waitInfo{.semaphoreCount = 1, .pSemaphores = &*_timeline, .pValues = &ticket};
+		while (vk::Result::eTimeout == _context.device().waitSemaphores(waitInfo, UINT64_MAX)) {}
+	}
+
+	Uploader::Batch &Uploader::currentBatch() {
+		if (_recording)
+			return *_recording;
+
+		_recording.emplace();
+		_recording->ticket = _timelineValue + (_dedicatedTransfer ? 2 : 1);
+
+		vk::CommandBufferAllocateInfo allocInfo{.commandPool = _transferPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1};
+		_recording->transferCommands = std::move(_context.device().allocateCommandBuffers(allocInfo).front());
+		_recording->transferCommands.begin(vk::CommandBufferBeginInfo{.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+		return *_recording;
+	}
+
+	Uploader::StagingRange Uploader::stage(Batch &batch, const void *data, vk::DeviceSize size) {
+		auto offset = _stagingRing.allocate(size, _stagingAlignment);
+		if (!offset) {
+			collect();
+			offset = _stagingRing.allocate(size, _stagingAlignment);
+		}
+
+		if (offset) {
+			memcpy(_stagingRing.mapped(*offset), data, static_cast<size_t>(size));
+			return {_stagingRing.buffer(), *offset};
+		}
+
+		// Ring exhausted by in-flight uploads: fall back to a temporary buffer released with the batch
+		vk::raii::Buffer buffer = nullptr;
+		Allocation memory;
+		_context.createStagingBuffer(data, size, buffer, memory);
+
+		const vk::Buffer handle = *buffer;
+		batch.stagingBuffers.push_back(std::move(buffer));
+		batch.stagingMemory.push_back(std::move(memory));
+		return {handle, 0};
+	}
+
+	void Uploader::collect() {
+		const uint64_t completed = _timeline.getCounterValue();
+
+		// Batches complete in submission order
+		while (!_inFlight.empty() && _inFlight.front().ticket <= completed)
+			_inFlight.pop_front();
+
+		_stagingRing.reclaim(completed);
+	}
+}
@@ -0,0 +1,114 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <core/common/RenderTypes.hpp>
+#include <core/utils/ThreadPool.hpp>
+
+namespace Core::Utils {
+
+	// Result of a background load, polled from any thread. Copies share the same load.
+	template <typename T>
+	class AssetHandle {
+	public:
+		AssetHandle() = default;
+
+		[[nodiscard]] bool valid() const { return _state != nullptr; }
+		[[nodiscard]] bool ready() const { return _state && _state->done.load(std::memory_order_acquire); }
+		[[nodiscard]] bool failed() const { return ready() && _state->error; }
+		[[nodiscard]] const std::string& path() const { return _state->path; }
+
+		// Only once ready, rethrows the error of a failed load
+		T& get() const {
+			if (!ready())
+				throw std::runtime_error("asset is not loaded yet : " + _state->path);
+			if (_state->error)
+				std::rethrow_exception(_state->error);
+			return _state->value;
+		}
+
+	private:
+		friend class AssetLoader;
+
+		struct State {
+			std::string path;
+			T value{};
+			std::exception_ptr error;
+			std::atomic<bool> done{false};
+		};
+
+		std::shared_ptr<State> _state;
+	};
+
+	// Decodes meshes and textures on a work-stealing pool. Finished loads are handed to their callback by
+	// dispatch(), on the thread calling it, so GPU uploads stay on the thread owning the renderer.
+	class AssetLoader {
+	public:
+		template <typename T>
+		using Callback = std::function<void(AssetHandle<T>&)>;
+
+		explicit AssetLoader(uint32_t threadCount = ThreadPool::defaultThreadCount());
+		~AssetLoader();
+
+		AssetLoader(const AssetLoader&) = delete;
+		AssetLoader& operator=(const AssetLoader&) = delete;
+
+		AssetHandle<MeshData> loadMesh(const std::string& filename, Callback<MeshData> onLoaded = {});
+		AssetHandle<TextureData> loadTexture(const std::string& filename, Callback<TextureData> onLoaded = {});
+
+		// Runs the callbacks of the loads finished since the last call, failed ones included, and returns
+		// how many loads it completed
+		uint32_t dispatch();
+
+		// Loads submitted and not dispatched yet
+		[[nodiscard]] uint32_t pending() const { return _pending.load(); }
+
+	private:
+		template <typename T>
+		AssetHandle<T> load(const std::string& filename, std::function<T(const std::string&)> loader, Callback<T> onLoaded);
+
+		std::mutex _mutex;
+		std::vector<std::function<void()>> _finished;
+		std::atomic<uint32_t> _pending{0};
+
+		// Last member: its destructor waits for the running loads, which still push to _finished
+		ThreadPool _threads;
+	};
+
+	template <typename T>
+	AssetHandle<T> AssetLoader::load(const std::string& filename, std::function<T(const std::string&)> loader, Callback<T> onLoaded) {
+		AssetHandle<T> handle;
+		handle._state = std::make_shared<typename AssetHandle<T>::State>();
+		handle._state->path = filename;
+		_pending.fetch_add(1);
+
+		_threads.submit([this, handle, loader = std::move(loader), onLoaded = std::move(onLoaded)]() mutable {
+			try {
+				handle._state->value = loader(handle._state->path);
+			} catch (...) {
+				handle._state->error = std::current_exception();
+			}
+			handle._state->done.store(true, std::memory_order_release);
+
+			std::lock_guard lock(_mutex);
+			_finished.push_back([handle, onLoaded = std::move(onLoaded)]() mutable {
+				if (onLoaded)
+					onLoaded(handle);
+			});
+		});
+
+		return handle;
+	}
+}
@@ -0,0 +1,85 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Core::Utils {
+
+	// Open addressing map with linear probing over one array, for hot lookups of small trivially copyable
+	// keys and values. There is no erase. Hash must spread its result over the low bits, see mix64.
+	template <typename Key, typename Value, typename Hash>
+	class FlatHashMap {
+	public:
+		explicit FlatHashMap(size_t expectedSize = 0) { reserve(expectedSize); }
+
+		[[nodiscard]] size_t size() const { return _size; }
+		[[nodiscard]] size_t capacity() const { return _slots.size(); }
+
+		// Sized so expectedSize entries stay under the maximum load factor
+		void reserve(size_t expectedSize) {
+			const size_t capacity = std::bit_ceil(expectedSize + expectedSize / 3 + 1);
+			if (capacity > _slots.size())
+				rehash(capacity);
+		}
+
+		// Inserts key with value unless it is present, in a single probe sequence. Returns the stored value
+		// and whether it was inserted.
+		std::pair<Value&, bool> tryEmplace(const Key& key, const Value& value) {
+			if ((_size + 1) * 4 > _slots.size() * 3)
+				rehash(std::max<size_t>(_slots.size() * 2, 16));
+
+			const size_t mask = _slots.size() - 1;
+			for (size_t i = Hash{}(key) & mask;; i = (i + 1) & mask) {
+				Slot& slot = _slots[i];
+				if (!slot.used) {
+					slot = {key, value, true};
+					_size++;
+					return {slot.value, true};
+				}
+				if (slot.key == key)
+					return {slot.value, false};
+			}
+		}
+
+		[[nodiscard]] const Value* find(const Key& key) const {
+			if (_slots.empty())
+				return nullptr;
+
+			const size_t mask = _slots.size() - 1;
+			for (size_t i = Hash{}(key) & mask;; i = (i + 1) & mask) {
+				const Slot& slot = _slots[i];
+				if (!slot.used)
+					return nullptr;
+				if (slot.key == key)
+					return &slot.value;
+			}
+		}
+
+	private:
+		struct Slot {
+			Key key;
+			Value value;
+			bool used;
+		};
+
+		void rehash(size_t capacity) {
+			std::vector<Slot> old = std::move(_slots);
+			_slots.assign(capacity, Slot{});
+			_size = 0;
+			for (const Slot& slot : old)
+				if (slot.used)
+					tryEmplace(slot.key, slot.value);
+		}
+
+		std::vector<Slot> _slots;
+		size_t _size = 0;
+	};
+}
@@ -0,0 +1,39 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Core::Utils {
+
+	constexpr uint64_t HASH_SEED = 14695981039346656037ull;
+
+	// FNV-1a, stable across runs unlike std::hash so it can key data persisted to disk
+	inline uint64_t hashBytes(const void* data, size_t size, uint64_t hash = HASH_SEED) {
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Hash a value without padding bytes, structs with padding must be hashed field by field
+	template<typename T>
+	uint64_t hashValue(const T& value, uint64_t hash = HASH_SEED) {
+		return hashBytes(&value, sizeof(value), hash);
+	}
+
+	// Finalizer of SplitMix64: every input bit affects every output bit, so the low bits can index a table
+	inline uint64_t mix64(uint64_t value) {
+		value ^= value >> 30;
+		value *= 0xbf58476d1ce4e5b9ull;
+		value ^= value >> 27;
+		value *= 0x94d049bb133111ebull;
+		value ^= value >> 31;
+		return value;
+	}
+}
@@ -8,5 +8,22 @@
 #include <core/common/RenderTypes.hpp>
 
 namespace Core::Utils {
+	// Decodes an image file with stb, .ktx2 files are mapped with readKtx2 instead
 	TextureData readTexture(const std::string &filename);
+
+	// Mip levels of a width x height image down to 1x1
+	uint32_t mipLevelCount(uint32_t width, uint32_t height);
+
+	// Bytes of one texel, or of one 4x4 block for compressed formats
+	uint32_t formatBlockBytes(TextureFormat format);
+	bool isBlockCompressed(TextureFormat format);
+
+	// Bytes of one width x height level, partial blocks on the edges count as whole ones
+	size_t mipLevelSize(TextureFormat format, uint32_t width, uint32_t height);
+	// Offset of level in texture.data(), from levelOffsets or the packed layout. Throws when the level does not fit.
+	size_t mipLevelOffset(const TextureData &texture, uint32_t level);
+
+	// Replaces the levels of an RGBA sRGB texture with its full chain, each level a 2x2 box filter of the
+	// previous one averaged in linear space. CPU fallback for formats the GPU cannot blit with linear filtering.
+	void generateMipChain(TextureData &textureData);
 }
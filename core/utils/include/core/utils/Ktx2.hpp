@@ -0,0 +1,18 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <string>
+
+#include <core/common/RenderTypes.hpp>
+
+namespace Core::Utils {
+	// Writes texture as a KTX2 file without supercompression, every mip level of texture.pixels included
+	void writeKtx2(const std::string& filename, const TextureData& texture);
+
+	// Maps a KTX2 file without supercompression holding one of the TextureFormat formats. The levels are not
+	// copied: the returned texture points into the mapping, which it keeps alive until the last copy is gone.
+	TextureData readKtx2(const std::string& filename);
+}
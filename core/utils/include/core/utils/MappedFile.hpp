@@ -0,0 +1,39 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Core::Utils {
+
+	// Read-only memory mapping of a whole file, pages are loaded on first access
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& filename);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		[[nodiscard]] const uint8_t* data() const { return _data; }
+		[[nodiscard]] size_t size() const { return _size; }
+		[[nodiscard]] std::span<const uint8_t> bytes() const { return {_data, _size}; }
+
+	private:
+		void close();
+
+		const uint8_t* _data = nullptr;
+		size_t _size = 0;
+#ifdef _WIN32
+		void* _mapping = nullptr;
+#endif
+	};
+}
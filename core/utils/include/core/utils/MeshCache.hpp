@@ -0,0 +1,43 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include <core/common/RenderTypes.hpp>
+
+namespace Core::Utils {
+
+	// Bumped whenever the file layout, Core::Vertex or the stored mesh processing changes, older files are
+	// then rebuilt
+	constexpr uint32_t MESH_CACHE_VERSION = 5;
+	constexpr const char* DEFAULT_MESH_CACHE_DIR = "mesh_cache";
+
+	// Identity of the file a cached mesh was built from
+	struct MeshSource {
+		uint64_t size = 0;
+		int64_t writeTime = 0;
+		uint64_t contentHash = 0;
+	};
+
+	// Size and modification time of filename, the content hash is left to hashMeshSource
+	MeshSource describeMeshSource(const std::string& filename);
+	uint64_t hashMeshSource(const std::string& filename);
+
+	// Cache file of source inside cacheDir, named after the absolute source path
+	std::filesystem::path meshCachePath(const std::string& source, const std::string& cacheDir);
+
+	// Maps a cache file and copies its blobs into a MeshData. Returns nothing when the file is missing,
+	// from another version or vertex layout, or built from a different source. A source only touched since
+	// is recognized by its content hash and the cache file is refreshed.
+	std::optional<MeshData> readMeshCache(const std::filesystem::path& cacheFile, const std::string& source);
+
+	// Writes through a temporary file and a rename, so readers never see a partial cache. Failures are
+	// logged and ignored, the cache is only an optimization.
+	void writeMeshCache(const std::filesystem::path& cacheFile, const MeshData& mesh, const MeshSource& source);
+}
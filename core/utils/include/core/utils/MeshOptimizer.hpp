@@ -0,0 +1,49 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <core/common/RenderTypes.hpp>
+
+namespace Core::Utils {
+
+	// Post-transform cache size the reordering and the statistics assume, about what current GPUs reuse
+	constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+	// Overdraw reordering is kept only while the cache miss ratio stays within this factor of Tipsify's
+	constexpr float OVERDRAW_ACMR_THRESHOLD = 1.05f;
+
+	struct VertexCacheStats {
+		float acmr = 0.0f; // cache misses per triangle, 0.5 is the ideal for a regular grid
+		float atvr = 0.0f; // cache misses per vertex, 1 is the ideal
+	};
+
+	struct MeshOptimizationStats {
+		VertexCacheStats cacheBefore;
+		VertexCacheStats cacheAfter;
+		float overdrawBefore = 0.0f; // shaded pixels per covered pixel, 1 means no overdraw
+		float overdrawAfter = 0.0f;
+	};
+
+	// FIFO cache simulation over the indices
+	VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = VERTEX_CACHE_SIZE);
+	// Software rasterization from the six axis directions with back-face culling and a depth test
+	float analyzeOverdraw(std::span<const uint32_t> indices, std::span<const Vertex> vertices);
+
+	// Tipsify (Sander, Nehab, Barczak 2007): reorders triangles for the post-transform cache. Returns the
+	// first triangle of every cluster, a new cluster starting wherever the walk had to jump.
+	std::vector<uint32_t> optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = VERTEX_CACHE_SIZE);
+	// Sorts the clusters so those facing outwards come first, then drops the new order if the cache miss
+	// ratio grew by more than threshold
+	void optimizeOverdraw(std::vector<uint32_t>& indices, std::span<const Vertex> vertices, std::span<const uint32_t> clusters,
+	                      float threshold = OVERDRAW_ACMR_THRESHOLD, uint32_t cacheSize = VERTEX_CACHE_SIZE);
+	// Renumbers vertices in the order the indices first use them, unused vertices are dropped
+	void optimizeVertexFetch(MeshData& mesh);
+
+	// Runs the three stages and reports the cache and overdraw figures before and after
+	MeshOptimizationStats optimizeMesh(MeshData& mesh);
+}
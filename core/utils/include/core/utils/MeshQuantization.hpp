@@ -0,0 +1,32 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <vector>
+
+#include <core/common/RenderTypes.hpp>
+
+namespace Core::Utils {
+
+	// Vertices of a mesh in a quantized format. Positions decode as offset + pos.xyz * scale, the renderer
+	// passes both to vertMainQuantized through the mesh's CullBatch entries.
+	struct QuantizedMesh {
+		VertexFormat format = VertexFormat::Quantized;
+		std::vector<QuantizedVertex> vertices;
+		glm::vec3 offset{0.0f};
+		glm::vec3 scale{1.0f};
+	};
+
+	// Smallest format that keeps the mesh as it is. Quantized formats store no color, so they are only chosen
+	// when every vertex color is white, the color loadMesh writes. Any other color, even a constant one, keeps Full.
+	VertexFormat chooseVertexFormat(const MeshData& mesh);
+
+	// Encodes the vertices of mesh, format must be one of the quantized ones
+	QuantizedMesh quantizeMesh(const MeshData& mesh, VertexFormat format);
+
+	uint16_t floatToHalf(float value);
+	// Octahedral mapping of a unit vector to [-1, 1]^2
+	glm::vec2 encodeOctahedral(glm::vec3 normal);
+}
@@ -0,0 +1,34 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <core/common/RenderTypes.hpp>
+
+namespace Core::Utils {
+
+	// Each level keeps about this fraction of the previous level's triangles
+	constexpr float LOD_REDUCTION = 0.5f;
+	// The chain ends once a level keeps more than this fraction of the previous one
+	constexpr float LOD_MIN_REDUCTION = 0.8f;
+	// Error a single level may add, relative to the diagonal of the mesh bounds
+	constexpr float LOD_MAX_RELATIVE_ERROR = 0.05f;
+
+	// Quadric error edge collapse (Garland, Heckbert 1997) that keeps the vertex buffer: an edge collapses
+	// onto one of its ends, so the result indexes the same vertices. Border edges only collapse along the
+	// border, UV and normal seams only along the seam with both sides moving together, and the error of a
+	// collapse includes the attribute change at the removed vertex.
+	// Stops at targetIndexCount or once the cheapest collapse left costs more than maxError, an object space
+	// distance. error receives the largest error introduced.
+	std::vector<uint32_t> simplifyMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+	                                   size_t targetIndexCount, float maxError, float* error = nullptr);
+
+	// Appends up to lodCount - 1 levels to mesh.indices, each simplified from the previous one and reordered
+	// for the vertex cache, and describes every level in mesh.lods
+	void buildLodChain(MeshData& mesh, uint32_t lodCount = MAX_MESH_LODS);
+}
@@ -3,7 +3,18 @@
 #include <string>
 
 #include <core/common/RenderTypes.hpp>
+#include <core/utils/MeshCache.hpp>
 
 namespace Core::Utils {
-	MeshData loadMesh(const std::string &filename);
+
+	class ThreadPool;
+
+	// Loads the binary cache of filename from cacheDir, or parses the OBJ, optimizes it with optimizeMesh,
+	// builds its levels of detail with buildLodChain and writes that cache. An empty cacheDir always parses.
+	MeshData loadMesh(const std::string &filename, const std::string &cacheDir = DEFAULT_MESH_CACHE_DIR,
+	                  ThreadPool *threads = nullptr);
+
+	// Maps an OBJ file, parses it on threads when given and deduplicates its vertices, without going
+	// through the cache
+	MeshData loadObj(const std::string &filename, ThreadPool *threads = nullptr);
 }
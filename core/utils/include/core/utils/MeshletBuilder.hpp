@@ -0,0 +1,25 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <core/common/RenderTypes.hpp>
+
+namespace Core::Utils {
+
+	// Splits indices into meshlets of at most maxVertices vertices and maxTriangles triangles and reorders
+	// them so each meshlet's triangles are contiguous. Meshlets grow greedily from a seed triangle through
+	// its neighbours, preferring those adding the fewest vertices and facing like the meshlet so far, which
+	// keeps them compact and their normal cones narrow. firstIndex values are relative to indices.
+	std::vector<Meshlet> buildMeshlets(std::span<const Vertex> vertices, std::span<uint32_t> indices,
+	                                   uint32_t maxVertices = MESHLET_MAX_VERTICES,
+	                                   uint32_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+	// Meshlets of the finest level of mesh, stored in mesh.meshlets
+	void buildMeshlets(MeshData& mesh);
+}
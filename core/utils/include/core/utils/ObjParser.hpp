@@ -0,0 +1,48 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <core/utils/Hash.hpp>
+
+namespace Core::Utils {
+
+	class ThreadPool;
+
+	// One corner of an OBJ face, zero based attribute indices or -1 when the attribute is absent
+	struct ObjCorner {
+		int32_t vertex;
+		int32_t normal;
+		int32_t texCoord;
+
+		bool operator==(const ObjCorner&) const = default;
+	};
+
+	// Equal triplets always build equal vertices, so loaders deduplicate on the corner rather than the vertex
+	struct ObjCornerHash {
+		size_t operator()(const ObjCorner& corner) const {
+			const uint64_t vertexNormal = static_cast<uint64_t>(static_cast<uint32_t>(corner.vertex)) << 32 |
+			                              static_cast<uint32_t>(corner.normal);
+			return static_cast<size_t>(mix64(vertexNormal + mix64(static_cast<uint32_t>(corner.texCoord))));
+		}
+	};
+
+	// Attributes and triangles of an OBJ file in file order. Polygons are split into fans, groups, objects
+	// and materials are ignored.
+	struct ObjData {
+		std::vector<float> positions; // xyz
+		std::vector<float> normals;   // xyz
+		std::vector<float> texCoords; // uv
+		std::vector<ObjCorner> corners; // three per triangle
+	};
+
+	// Parses OBJ text. With a pool the text is split into line aligned chunks parsed in parallel, then
+	// merged in order. Throws on malformed lines and out of range indices.
+	ObjData parseObj(std::string_view text, ThreadPool* threads = nullptr);
+}
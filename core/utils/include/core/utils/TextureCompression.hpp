@@ -0,0 +1,16 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <core/common/RenderTypes.hpp>
+
+namespace Core::Utils {
+
+	class ThreadPool;
+
+	// Encodes every mip level of an RGBA8 texture into a BCn format. Rows of blocks are spread over
+	// threads when a pool is given. BC5 keeps the red and green channels.
+	TextureData compressTexture(const TextureData& rgba, TextureFormat format, ThreadPool* threads = nullptr);
+}
@@ -0,0 +1,68 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core::Utils {
+
+	// Fixed set of worker threads, each with its own task queue. A worker runs its newest task first and
+	// steals the oldest task of another worker once its queue is empty, so long tasks such as asset decoding
+	// do not leave threads idle behind a busy one.
+	class ThreadPool {
+	public:
+		// One worker per hardware thread, minus the calling thread
+		static uint32_t defaultThreadCount();
+
+		explicit ThreadPool(uint32_t threadCount = defaultThreadCount());
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		[[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(_workers.size()); }
+
+		// Queues task on the calling worker when called from a task of this pool, spreads it over the workers
+		// otherwise. Without workers the task runs before submit returns.
+		std::future<void> submit(std::function<void()> task);
+
+		// Runs task(i) for every i in [0, count) on the workers and the calling thread, and returns once all
+		// of them are done. Each index runs exactly once, so per-index resources need no locking.
+		// The first exception thrown by a task is rethrown here. Called from a task of this pool, the worker
+		// keeps running queued tasks while it waits, so nested loops cannot starve the pool.
+		void parallelFor(uint32_t count, const std::function<void(uint32_t)>& task);
+
+	private:
+		struct Queue {
+			std::mutex mutex;
+			std::deque<std::packaged_task<void()>> tasks;
+		};
+
+		void workerLoop(uint32_t index);
+		// Own queue from the back, then the other queues from the front
+		bool popTask(uint32_t index, std::packaged_task<void()>& task);
+
+		std::vector<std::unique_ptr<Queue>> _queues;
+		std::vector<std::thread> _workers;
+		std::atomic<uint32_t> _nextQueue{0};
+
+		// Sleeping workers wait for _pending to become non zero, it counts the tasks of every queue
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		std::atomic<int64_t> _pending{0};
+		bool _stopping = false;
+	};
+}
@@ -0,0 +1,54 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/AssetLoader.hpp>
+#include <core/utils/ImageUtils.hpp>
+#include <core/utils/MeshUtils.hpp>
+
+#include <iostream>
+#include <iterator>
+
+namespace Core::Utils {
+
+	AssetLoader::AssetLoader(uint32_t threadCount)
+		: _threads(threadCount) {
+		std::cout << "[ASTRO CORE] [UTILS] [ASSETS] loading on " << _threads.size() << " threads" << std::endl;
+	}
+
+	AssetLoader::~AssetLoader() = default;
+
+	AssetHandle<MeshData> AssetLoader::loadMesh(const std::string &filename, Callback<MeshData> onLoaded) {
+		// Large files also spread their parse over the pool, the waiting worker keeps running other loads
+		return load<MeshData>(filename, [this](const std::string &path) {
+			return Utils::loadMesh(path, DEFAULT_MESH_CACHE_DIR, &_threads);
+		}, std::move(onLoaded));
+	}
+
+	AssetHandle<TextureData> AssetLoader::loadTexture(const std::string &filename, Callback<TextureData> onLoaded) {
+		return load<TextureData>(filename, [](const std::string &path) { return Utils::readTexture(path); }, std::move(onLoaded));
+	}
+
+	uint32_t AssetLoader::dispatch() {
+		std::vector<std::function<void()>> finished;
+		{
+			std::lock_guard lock(_mutex);
+			finished.swap(_finished);
+		}
+
+		// Callbacks may start new loads, the lock is not held while they run
+		for (size_t i = 0; i < finished.size(); i++) {
+			_pending.fetch_sub(1);
+			try {
+				finished[i]();
+			} catch (...) {
+				// The loads after the throwing callback are dispatched by the next call
+				std::lock_guard lock(_mutex);
+				_finished.insert(_finished.begin(), std::make_move_iterator(finished.begin() + static_cast<std::ptrdiff_t>(i) + 1),
+				                 std::make_move_iterator(finished.end()));
+				throw;
+			}
+		}
+		return static_cast<uint32_t>(finished.size());
+	}
+}
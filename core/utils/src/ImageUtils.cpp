@@ -3,29 +3,173 @@
 //
 
 #include <core/utils/ImageUtils.hpp>
+#include <core/utils/Ktx2.hpp>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-#include <cstring>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <memory>
 #include <stdexcept>
 
 
 namespace Core::Utils {
 	TextureData readTexture(const std::string &filename) {
+		if (filename.ends_with(".ktx2"))
+			return readKtx2(filename);
+
 		int texWidth, texHeight, texChannels;
 		stbi_uc* pixels = stbi_load(filename.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 		if (!pixels)
 			throw std::runtime_error("failed to load texture image!");
 
+		// The texture takes over the decoder's buffer, the last copy of it frees it
 		TextureData textureData;
 		textureData.width = texWidth;
 		textureData.height = texHeight;
 		textureData.nbChannels = texChannels;
-		textureData.pixels.resize(texWidth * texHeight * 4);
-		std::memcpy(textureData.pixels.data(), pixels, texWidth * texHeight * 4);
-		stbi_image_free(pixels);
+		textureData.external = {pixels, static_cast<size_t>(texWidth) * texHeight * 4};
+		textureData.owner = std::shared_ptr<const stbi_uc>(pixels, stbi_image_free);
 
 		return textureData;
 	}
-}
\ No newline at end of file
+
+	uint32_t mipLevelCount(uint32_t width, uint32_t height) {
+		return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+	}
+
+	uint32_t formatBlockBytes(TextureFormat format) {
+		switch (format) {
+			case TextureFormat::BC1Srgb: return 8;
+			case TextureFormat::BC3Srgb:
+			case TextureFormat::BC5Unorm:
+			case TextureFormat::BC7Srgb: return 16;
+			default: return 4;
+		}
+	}
+
+	bool isBlockCompressed(TextureFormat format) {
+		return format != TextureFormat::RGBA8Srgb;
+	}
+
+	size_t mipLevelSize(TextureFormat format, uint32_t width, uint32_t height) {
+		if (isBlockCompressed(format)) {
+			width = (width + 3) / 4;
+			height = (height + 3) / 4;
+		}
+		return static_cast<size_t>(width) * height * formatBlockBytes(format);
+	}
+
+	size_t mipLevelOffset(const TextureData &texture, uint32_t level) {
+		const auto levelSize = [&](uint32_t l) {
+			return mipLevelSize(texture.format, std::max(texture.width >> l, 1u), std::max(texture.height >> l, 1u));
+		};
+
+		size_t offset = 0;
+		if (texture.levelOffsets.empty()) {
+			for (uint32_t l = 0; l < level; l++)
+				offset += levelSize(l);
+		} else {
+			if (level >= texture.levelOffsets.size())
+				throw std::runtime_error("texture has no offset for this mip level");
+			offset = texture.levelOffsets[level];
+		}
+
+		if (offset + levelSize(level) > texture.data().size())
+			throw std::runtime_error("texture pixels are smaller than their mip levels");
+		return offset;
+	}
+
+	static float srgbToLinear(float value) {
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	static uint8_t linearToSrgb(float value) {
+		const float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		return static_cast<uint8_t>(std::clamp(srgb, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+	void generateMipChain(TextureData &textureData) {
+		static const std::array<float, 256> toLinear = [] {
+			std::array<float, 256> table{};
+			for (size_t i = 0; i < table.size(); i++)
+				table[i] = srgbToLinear(static_cast<float>(i) / 255.0f);
+			return table;
+		}();
+
+		if (textureData.format != TextureFormat::RGBA8Srgb)
+			throw std::runtime_error("mip chains are only generated for RGBA8 textures");
+
+		const uint32_t levels = mipLevelCount(textureData.width, textureData.height);
+
+		// Keep the base level only, the whole chain adds a third to it. Texels held outside of pixels are
+		// brought in since the chain is appended to them.
+		const size_t baseSize = static_cast<size_t>(textureData.width) * textureData.height * 4;
+		if (!textureData.external.empty()) {
+			const std::span<const uint8_t> base = textureData.data().subspan(mipLevelOffset(textureData, 0), baseSize);
+			textureData.pixels.assign(base.begin(), base.end());
+			textureData.external = {};
+			textureData.owner.reset();
+		} else if (!textureData.levelOffsets.empty()) {
+			const size_t baseOffset = mipLevelOffset(textureData, 0);
+			textureData.pixels.erase(textureData.pixels.begin(), textureData.pixels.begin() + static_cast<std::ptrdiff_t>(baseOffset));
+		}
+		textureData.levelOffsets.clear();
+		textureData.pixels.resize(baseSize);
+		textureData.pixels.reserve(baseSize + baseSize / 3 + 4 * levels);
+
+		size_t srcOffset = 0;
+		uint32_t srcWidth = textureData.width;
+		uint32_t srcHeight = textureData.height;
+
+		for (uint32_t level = 1; level < levels; level++) {
+			const uint32_t dstWidth = std::max(srcWidth / 2, 1u);
+			const uint32_t dstHeight = std::max(srcHeight / 2, 1u);
+			const size_t dstOffset = textureData.pixels.size();
+			textureData.pixels.resize(dstOffset + static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+			const uint8_t* src = textureData.pixels.data() + srcOffset;
+			uint8_t* dst = textureData.pixels.data() + dstOffset;
+
+			for (uint32_t y = 0; y < dstHeight; y++) {
+				// Odd sizes clamp the second row or column onto the first one
+				const uint32_t y0 = std::min(2 * y, srcHeight - 1);
+				const uint32_t y1 = std::min(2 * y + 1, srcHeight - 1);
+
+				for (uint32_t x = 0; x < dstWidth; x++) {
+					const uint32_t x0 = std::min(2 * x, srcWidth - 1);
+					const uint32_t x1 = std::min(2 * x + 1, srcWidth - 1);
+					const std::array<const uint8_t*, 4> texels = {
+						src + (static_cast<size_t>(y0) * srcWidth + x0) * 4,
+						src + (static_cast<size_t>(y0) * srcWidth + x1) * 4,
+						src + (static_cast<size_t>(y1) * srcWidth + x0) * 4,
+						src + (static_cast<size_t>(y1) * srcWidth + x1) * 4
+					};
+
+					uint8_t* out = dst + (static_cast<size_t>(y) * dstWidth + x) * 4;
+					for (int channel = 0; channel < 3; channel++) {
+						float sum = 0.0f;
+						for (const uint8_t* texel : texels)
+							sum += toLinear[texel[channel]];
+						out[channel] = linearToSrgb(sum * 0.25f);
+					}
+
+					// Alpha is stored linearly
+					uint32_t alpha = 0;
+					for (const uint8_t* texel : texels)
+						alpha += texel[3];
+					out[3] = static_cast<uint8_t>((alpha + 2) / 4);
+				}
+			}
+
+			srcOffset = dstOffset;
+			srcWidth = dstWidth;
+			srcHeight = dstHeight;
+		}
+
+		textureData.mipLevels = levels;
+	}
+}
@@ -0,0 +1,255 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/Ktx2.hpp>
+#include <core/utils/ImageUtils.hpp>
+#include <core/utils/MappedFile.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Core::Utils {
+
+	// region Layout
+	static constexpr std::array<uint8_t, 12> KTX2_IDENTIFIER = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+	// The 64 bit offsets of the index sit on 4 byte boundaries in the file
+#pragma pack(push, 4)
+	struct Ktx2Header {
+		uint32_t vkFormat;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset;
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset;
+		uint64_t sgdByteLength;
+	};
+#pragma pack(pop)
+	static_assert(sizeof(Ktx2Header) == 68);
+
+	struct Ktx2Level {
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+
+	// Data format descriptor constants, Khronos Data Format Specification 1.3
+	static constexpr uint8_t DFD_MODEL_RGBSDA = 1;
+	static constexpr uint8_t DFD_MODEL_BC1A = 128;
+	static constexpr uint8_t DFD_MODEL_BC3 = 130;
+	static constexpr uint8_t DFD_MODEL_BC5 = 132;
+	static constexpr uint8_t DFD_MODEL_BC7 = 134;
+	static constexpr uint8_t DFD_PRIMARIES_BT709 = 1;
+	static constexpr uint8_t DFD_TRANSFER_LINEAR = 1;
+	static constexpr uint8_t DFD_TRANSFER_SRGB = 2;
+	static constexpr uint8_t DFD_CHANNEL_ALPHA = 15;
+	static constexpr uint8_t DFD_SAMPLE_LINEAR = 0x10;
+
+	struct DfdSample {
+		uint16_t bitOffset;
+		uint8_t bitLength; // minus one
+		uint8_t channelType;
+		uint32_t upper;
+	};
+
+	static uint32_t vkFormatOf(TextureFormat format) {
+		switch (format) {
+			case TextureFormat::BC1Srgb: return 132;  // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+			case TextureFormat::BC3Srgb: return 138;  // VK_FORMAT_BC3_SRGB_BLOCK
+			case TextureFormat::BC5Unorm: return 141; // VK_FORMAT_BC5_UNORM_BLOCK
+			case TextureFormat::BC7Srgb: return 146;  // VK_FORMAT_BC7_SRGB_BLOCK
+			default: return 43;                       // VK_FORMAT_R8G8B8A8_SRGB
+		}
+	}
+
+	static TextureFormat textureFormatOf(uint32_t vkFormat) {
+		switch (vkFormat) {
+			case 43: return TextureFormat::RGBA8Srgb;
+			case 132: return TextureFormat::BC1Srgb;
+			case 138: return TextureFormat::BC3Srgb;
+			case 141: return TextureFormat::BC5Unorm;
+			case 146: return TextureFormat::BC7Srgb;
+			default: throw std::runtime_error("unsupported KTX2 vkFormat " + std::to_string(vkFormat));
+		}
+	}
+
+	static uint32_t channelCountOf(TextureFormat format) {
+		switch (format) {
+			case TextureFormat::BC1Srgb: return 3;
+			case TextureFormat::BC5Unorm: return 2;
+			default: return 4;
+		}
+	}
+
+	// Basic descriptor block, preceded by the total DFD size
+	static std::vector<uint32_t> buildDfd(TextureFormat format) {
+		uint8_t model = DFD_MODEL_RGBSDA;
+		uint8_t transfer = DFD_TRANSFER_SRGB;
+		std::vector<DfdSample> samples;
+
+		switch (format) {
+			case TextureFormat::BC1Srgb:
+				model = DFD_MODEL_BC1A;
+				samples = {{0, 63, 0, UINT32_MAX}};
+				break;
+			case TextureFormat::BC3Srgb:
+				model = DFD_MODEL_BC3;
+				samples = {{0, 63, DFD_CHANNEL_ALPHA | DFD_SAMPLE_LINEAR, UINT32_MAX}, {64, 63, 0, UINT32_MAX}};
+				break;
+			case TextureFormat::BC5Unorm:
+				model = DFD_MODEL_BC5;
+				transfer = DFD_TRANSFER_LINEAR;
+				samples = {{0, 63, 0, UINT32_MAX}, {64, 63, 1, UINT32_MAX}};
+				break;
+			case TextureFormat::BC7Srgb:
+				model = DFD_MODEL_BC7;
+				samples = {{0, 127, 0, UINT32_MAX}};
+				break;
+			default:
+				samples = {{0, 7, 0, 255}, {8, 7, 1, 255}, {16, 7, 2, 255}, {24, 7, DFD_CHANNEL_ALPHA | DFD_SAMPLE_LINEAR, 255}};
+				break;
+		}
+
+		const bool compressed = isBlockCompressed(format);
+		const uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+
+		std::vector<uint32_t> words;
+		words.push_back(4 + blockSize);
+		words.push_back(0);                            // vendor Khronos, basic descriptor type
+		words.push_back(2u | blockSize << 16);         // version 1.3
+		words.push_back(model | DFD_PRIMARIES_BT709 << 8 | static_cast<uint32_t>(transfer) << 16);
+		words.push_back(compressed ? 3u | 3u << 8 : 0u); // texel block dimensions minus one
+		words.push_back(formatBlockBytes(format));     // bytes of plane 0
+		words.push_back(0);
+
+		for (const DfdSample& sample : samples) {
+			words.push_back(sample.bitOffset | static_cast<uint32_t>(sample.bitLength) << 16 | static_cast<uint32_t>(sample.channelType) << 24);
+			words.push_back(0); // sample position
+			words.push_back(0); // lower
+			words.push_back(sample.upper);
+		}
+		return words;
+	}
+	// endregion
+
+	void writeKtx2(const std::string &filename, const TextureData &texture) {
+		const std::vector<uint32_t> dfd = buildDfd(texture.format);
+		const uint32_t blockBytes = formatBlockBytes(texture.format);
+
+		// Level data follows the descriptor, smallest level first, each aligned to the block size
+		const size_t indexEnd = KTX2_IDENTIFIER.size() + sizeof(Ktx2Header) + sizeof(Ktx2Level) * texture.mipLevels;
+		const size_t dfdEnd = indexEnd + dfd.size() * sizeof(uint32_t);
+
+		std::vector<Ktx2Level> levels(texture.mipLevels);
+		std::vector<size_t> sourceOffsets(texture.mipLevels);
+		for (uint32_t level = 0; level < texture.mipLevels; level++) {
+			sourceOffsets[level] = mipLevelOffset(texture, level);
+			levels[level].byteLength = mipLevelSize(texture.format, std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u));
+			levels[level].uncompressedByteLength = levels[level].byteLength;
+		}
+
+		size_t fileOffset = dfdEnd;
+		for (uint32_t level = texture.mipLevels; level-- > 0;) {
+			fileOffset = (fileOffset + blockBytes - 1) / blockBytes * blockBytes;
+			levels[level].byteOffset = fileOffset;
+			fileOffset += levels[level].byteLength;
+		}
+
+		const Ktx2Header header{
+			.vkFormat = vkFormatOf(texture.format),
+			.typeSize = 1,
+			.pixelWidth = texture.width,
+			.pixelHeight = texture.height,
+			.pixelDepth = 0,
+			.layerCount = 0,
+			.faceCount = 1,
+			.levelCount = texture.mipLevels,
+			.supercompressionScheme = 0,
+			.dfdByteOffset = static_cast<uint32_t>(indexEnd),
+			.dfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t)),
+			.kvdByteOffset = 0,
+			.kvdByteLength = 0,
+			.sgdByteOffset = 0,
+			.sgdByteLength = 0
+		};
+
+		std::vector<uint8_t> file(fileOffset, 0);
+		memcpy(file.data(), KTX2_IDENTIFIER.data(), KTX2_IDENTIFIER.size());
+		memcpy(file.data() + KTX2_IDENTIFIER.size(), &header, sizeof(header));
+		memcpy(file.data() + KTX2_IDENTIFIER.size() + sizeof(header), levels.data(), sizeof(Ktx2Level) * levels.size());
+		memcpy(file.data() + indexEnd, dfd.data(), dfd.size() * sizeof(uint32_t));
+		for (uint32_t level = 0; level < texture.mipLevels; level++)
+			memcpy(file.data() + levels[level].byteOffset, texture.data().data() + sourceOffsets[level], levels[level].byteLength);
+
+		std::ofstream out(filename, std::ios::binary);
+		if (!out)
+			throw std::runtime_error("failed to open " + filename);
+		out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+	}
+
+	TextureData readKtx2(const std::string &filename) {
+		auto file = std::make_shared<MappedFile>(filename);
+		const std::span<const uint8_t> bytes = file->bytes();
+
+		if (bytes.size() < KTX2_IDENTIFIER.size() + sizeof(Ktx2Header) ||
+		    memcmp(bytes.data(), KTX2_IDENTIFIER.data(), KTX2_IDENTIFIER.size()) != 0)
+			throw std::runtime_error("not a KTX2 file : " + filename);
+
+		// The mapping gives no alignment guarantee past the page, fields are copied out
+		Ktx2Header header{};
+		memcpy(&header, bytes.data() + KTX2_IDENTIFIER.size(), sizeof(header));
+
+		if (header.supercompressionScheme != 0)
+			throw std::runtime_error("supercompressed KTX2 files are not supported : " + filename);
+		if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 ||
+		    header.layerCount > 1 || header.faceCount != 1)
+			throw std::runtime_error("only single 2D KTX2 images are supported : " + filename);
+
+		TextureData texture{
+			.pixels = {},
+			.width = header.pixelWidth,
+			.height = header.pixelHeight,
+			.nbChannels = 0,
+			.mipLevels = std::max(header.levelCount, 1u), // 0 asks the loader to generate the chain
+			.format = textureFormatOf(header.vkFormat)
+		};
+		texture.nbChannels = channelCountOf(texture.format);
+
+		if (texture.mipLevels > mipLevelCount(texture.width, texture.height))
+			throw std::runtime_error("KTX2 file has more mip levels than its size allows : " + filename);
+
+		const size_t indexOffset = KTX2_IDENTIFIER.size() + sizeof(Ktx2Header);
+		if (bytes.size() < indexOffset + sizeof(Ktx2Level) * texture.mipLevels)
+			throw std::runtime_error("truncated KTX2 level index : " + filename);
+
+		texture.levelOffsets.resize(texture.mipLevels);
+		for (uint32_t level = 0; level < texture.mipLevels; level++) {
+			Ktx2Level entry{};
+			memcpy(&entry, bytes.data() + indexOffset + sizeof(Ktx2Level) * level, sizeof(entry));
+
+			const size_t expected = mipLevelSize(texture.format, std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u));
+			if (entry.byteLength != expected || entry.byteOffset > bytes.size() || bytes.size() - entry.byteOffset < entry.byteLength)
+				throw std::runtime_error("invalid KTX2 mip level " + std::to_string(level) + " : " + filename);
+			texture.levelOffsets[level] = static_cast<size_t>(entry.byteOffset);
+		}
+
+		texture.external = bytes;
+		texture.owner = std::move(file);
+		return texture;
+	}
+}
@@ -0,0 +1,109 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/MappedFile.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Core::Utils {
+
+	MappedFile::MappedFile(const std::string &filename) {
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("failed to open file : " + filename);
+
+		LARGE_INTEGER size;
+		GetFileSizeEx(file, &size);
+		_size = static_cast<size_t>(size.QuadPart);
+
+		// Empty files cannot be mapped, they stay an empty range
+		if (_size > 0) {
+			_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (_mapping)
+				_data = static_cast<const uint8_t *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+		CloseHandle(file);
+
+		if (_size > 0 && !_data) {
+			close();
+			throw std::runtime_error("failed to map file : " + filename);
+		}
+#else
+		const int file = open(filename.c_str(), O_RDONLY);
+		if (file < 0)
+			throw std::runtime_error("failed to open file : " + filename);
+
+		struct stat status{};
+		if (fstat(file, &status) != 0) {
+			::close(file);
+			throw std::runtime_error("failed to stat file : " + filename);
+		}
+		_size = static_cast<size_t>(status.st_size);
+
+		// Empty files cannot be mapped, they stay an empty range
+		if (_size > 0) {
+			void *mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (mapping == MAP_FAILED) {
+				::close(file);
+				throw std::runtime_error("failed to map file : " + filename);
+			}
+			// Readers walk the file front to back once
+			madvise(mapping, _size, MADV_SEQUENTIAL);
+			_data = static_cast<const uint8_t *>(mapping);
+		}
+		::close(file);
+#endif
+	}
+
+	MappedFile::~MappedFile() {
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile &&other) noexcept
+		: _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0))
+#ifdef _WIN32
+		, _mapping(std::exchange(other._mapping, nullptr))
+#endif
+	{}
+
+	MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+		if (this != &other) {
+			close();
+			_data = std::exchange(other._data, nullptr);
+			_size = std::exchange(other._size, 0);
+#ifdef _WIN32
+			_mapping = std::exchange(other._mapping, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+	void MappedFile::close() {
+#ifdef _WIN32
+		if (_data)
+			UnmapViewOfFile(_data);
+		if (_mapping)
+			CloseHandle(_mapping);
+		_mapping = nullptr;
+#else
+		if (_data)
+			munmap(const_cast<uint8_t *>(_data), _size);
+#endif
+		_data = nullptr;
+		_size = 0;
+	}
+}
@@ -0,0 +1,279 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/MeshCache.hpp>
+#include <core/utils/Hash.hpp>
+#include <core/utils/MappedFile.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Core::Utils {
+
+	// region Layout
+	static constexpr std::array<char, 4> MESH_CACHE_MAGIC = {'A', 'M', 'S', 'H'};
+	static constexpr uint64_t BLOB_ALIGNMENT = 16;
+
+	struct MeshCacheHeader {
+		std::array<char, 4> magic;
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		uint64_t sourceHash;
+		float boundsMin[3];
+		float boundsMax[3];
+		uint32_t vertexStride;
+		uint32_t attributeCount;
+		uint64_t vertexCount;
+		uint64_t indexCount;
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+		uint32_t indexStride; // 2 or 4 bytes, see IndexType
+		uint32_t lodCount;    // MeshLod entries following the attribute layout
+		uint32_t meshletCount; // Meshlet entries following the levels, aligned
+		uint32_t padding;
+	};
+	static_assert(sizeof(MeshCacheHeader) == 112);
+
+	enum class AttributeSemantic : uint32_t { Position, Color, Normal, TexCoord };
+	enum class ComponentType : uint32_t { Float32 };
+
+	// Describes one member of the vertex blob, compared as a whole against the current Vertex
+	struct MeshCacheAttribute {
+		AttributeSemantic semantic;
+		ComponentType componentType;
+		uint32_t componentCount;
+		uint32_t offset;
+
+		bool operator==(const MeshCacheAttribute&) const = default;
+	};
+
+	static constexpr std::array<MeshCacheAttribute, 4> VERTEX_LAYOUT = {{
+		{AttributeSemantic::Position, ComponentType::Float32, 3, offsetof(Vertex, pos)},
+		{AttributeSemantic::Color, ComponentType::Float32, 3, offsetof(Vertex, color)},
+		{AttributeSemantic::Normal, ComponentType::Float32, 3, offsetof(Vertex, normal)},
+		{AttributeSemantic::TexCoord, ComponentType::Float32, 2, offsetof(Vertex, texCoord)}
+	}};
+
+	static uint64_t alignUp(uint64_t value) {
+		return (value + BLOB_ALIGNMENT - 1) / BLOB_ALIGNMENT * BLOB_ALIGNMENT;
+	}
+
+	// ".tmp" followed by a value drawn from a per process seed, the writing thread and a write counter
+	static std::string temporarySuffix() {
+		static const uint64_t processSeed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+		static std::atomic<uint64_t> writeCounter = 0;
+
+		uint64_t value = hashValue(std::hash<std::thread::id>{}(std::this_thread::get_id()), processSeed);
+		value = hashValue(writeCounter.fetch_add(1, std::memory_order_relaxed), value);
+
+		std::ostringstream suffix;
+		suffix << ".tmp" << std::hex << std::setw(16) << std::setfill('0') << value;
+		return suffix.str();
+	}
+	// endregion
+
+	MeshSource describeMeshSource(const std::string &filename) {
+		return MeshSource{
+			.size = static_cast<uint64_t>(std::filesystem::file_size(filename)),
+			.writeTime = static_cast<int64_t>(std::filesystem::last_write_time(filename).time_since_epoch().count()),
+			.contentHash = 0
+		};
+	}
+
+	uint64_t hashMeshSource(const std::string &filename) {
+		const MappedFile file(filename);
+		return hashBytes(file.data(), file.size());
+	}
+
+	std::filesystem::path meshCachePath(const std::string &source, const std::string &cacheDir) {
+		const std::string absolute = std::filesystem::absolute(source).lexically_normal().string();
+
+		std::ostringstream name;
+		name << std::filesystem::path(source).stem().string() << '_'
+			 << std::hex << std::setw(16) << std::setfill('0') << hashBytes(absolute.data(), absolute.size()) << ".amesh";
+		return std::filesystem::path(cacheDir) / name.str();
+	}
+
+	std::optional<MeshData> readMeshCache(const std::filesystem::path &cacheFile, const std::string &source) {
+		std::error_code error;
+		if (!std::filesystem::exists(cacheFile, error))
+			return std::nullopt;
+
+		MappedFile file(cacheFile.string());
+		if (file.size() < sizeof(MeshCacheHeader))
+			return std::nullopt;
+
+		MeshCacheHeader header{};
+		memcpy(&header, file.data(), sizeof(header));
+		if (header.magic != MESH_CACHE_MAGIC || header.version != MESH_CACHE_VERSION ||
+		    header.vertexStride != sizeof(Vertex) || header.attributeCount != VERTEX_LAYOUT.size())
+			return std::nullopt;
+
+		std::array<MeshCacheAttribute, VERTEX_LAYOUT.size()> layout{};
+		if (file.size() < sizeof(header) + sizeof(layout))
+			return std::nullopt;
+		memcpy(layout.data(), file.data() + sizeof(header), sizeof(layout));
+		if (layout != VERTEX_LAYOUT)
+			return std::nullopt;
+
+		if (header.lodCount > MAX_MESH_LODS || file.size() < sizeof(header) + sizeof(layout) + header.lodCount * sizeof(MeshLod))
+			return std::nullopt;
+		std::vector<MeshLod> lods(header.lodCount);
+		memcpy(lods.data(), file.data() + sizeof(header) + sizeof(layout), lods.size() * sizeof(MeshLod));
+		for (const MeshLod& lod : lods)
+			if (lod.firstIndex > header.indexCount || lod.indexCount > header.indexCount - lod.firstIndex)
+				return std::nullopt;
+
+		const uint64_t meshletOffset = alignUp(sizeof(header) + sizeof(layout) + header.lodCount * sizeof(MeshLod));
+		if (meshletOffset > file.size() || header.meshletCount > (file.size() - meshletOffset) / sizeof(Meshlet))
+			return std::nullopt;
+		std::vector<Meshlet> meshlets(header.meshletCount);
+		memcpy(meshlets.data(), file.data() + meshletOffset, meshlets.size() * sizeof(Meshlet));
+		for (const Meshlet& meshlet : meshlets)
+			if (meshlet.firstIndex > header.indexCount || meshlet.triangleCount > (header.indexCount - meshlet.firstIndex) / 3)
+				return std::nullopt;
+
+		if (header.indexStride != sizeof(uint16_t) && header.indexStride != sizeof(uint32_t))
+			return std::nullopt;
+		const IndexType indexType = header.indexStride == sizeof(uint16_t) ? IndexType::Uint16 : IndexType::Uint32;
+		if (indexType == IndexType::Uint16 && header.vertexCount > MAX_UINT16_INDEXED_VERTICES)
+			return std::nullopt;
+
+		const uint64_t vertexBytes = header.vertexCount * sizeof(Vertex);
+		const uint64_t indexBytes = header.indexCount * header.indexStride;
+		if (header.vertexCount > file.size() / sizeof(Vertex) || header.indexCount > file.size() / header.indexStride ||
+		    header.vertexOffset > file.size() - vertexBytes || header.indexOffset > file.size() - indexBytes)
+			return std::nullopt;
+
+		// Cheap check first, the content hash only settles sources whose time changed but not their size
+		const MeshSource current = describeMeshSource(source);
+		bool refresh = false;
+		if (current.size != header.sourceSize)
+			return std::nullopt;
+		if (current.writeTime != header.sourceWriteTime) {
+			if (hashMeshSource(source) != header.sourceHash)
+				return std::nullopt;
+			refresh = true;
+		}
+
+		MeshData mesh;
+		mesh.vertices.resize(header.vertexCount);
+		mesh.indices.resize(header.indexCount);
+		mesh.indexType = indexType;
+		mesh.lods = std::move(lods);
+		mesh.meshlets = std::move(meshlets);
+		memcpy(mesh.vertices.data(), file.data() + header.vertexOffset, vertexBytes);
+		if (indexType == IndexType::Uint16) {
+			std::vector<uint16_t> narrow(header.indexCount);
+			memcpy(narrow.data(), file.data() + header.indexOffset, indexBytes);
+			std::ranges::copy(narrow, mesh.indices.begin());
+		} else {
+			memcpy(mesh.indices.data(), file.data() + header.indexOffset, indexBytes);
+		}
+		// An index past the vertices would read out of bounds on the GPU, reload such a cache from source
+		if (std::ranges::any_of(mesh.indices, [&](uint32_t index) { return index >= header.vertexCount; }))
+			return std::nullopt;
+
+		// Unmapped first, some platforms refuse to replace a mapped file
+		file = MappedFile();
+		if (refresh)
+			writeMeshCache(cacheFile, mesh, MeshSource{current.size, current.writeTime, header.sourceHash});
+
+		return mesh;
+	}
+
+	void writeMeshCache(const std::filesystem::path &cacheFile, const MeshData &mesh, const MeshSource &source) {
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+		for (const Vertex& vertex : mesh.vertices) {
+			min = glm::min(min, vertex.pos);
+			max = glm::max(max, vertex.pos);
+		}
+		if (mesh.vertices.empty())
+			min = max = glm::vec3(0.0f);
+
+		if (mesh.indexType == IndexType::Uint16 && mesh.vertices.size() > MAX_UINT16_INDEXED_VERTICES)
+			throw std::runtime_error("mesh has too many vertices for 16 bit indices");
+		const uint32_t indexStride = mesh.indexType == IndexType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		if (mesh.lods.size() > MAX_MESH_LODS)
+			throw std::runtime_error("mesh has too many levels of detail");
+		const uint64_t lodBytes = mesh.lods.size() * sizeof(MeshLod);
+
+		const uint64_t meshletOffset = alignUp(sizeof(MeshCacheHeader) + sizeof(VERTEX_LAYOUT) + lodBytes);
+		const uint64_t meshletBytes = mesh.meshlets.size() * sizeof(Meshlet);
+		const uint64_t vertexOffset = alignUp(meshletOffset + meshletBytes);
+		const uint64_t indexOffset = alignUp(vertexOffset + mesh.vertices.size() * sizeof(Vertex));
+
+		const MeshCacheHeader header{
+			.magic = MESH_CACHE_MAGIC,
+			.version = MESH_CACHE_VERSION,
+			.sourceSize = source.size,
+			.sourceWriteTime = source.writeTime,
+			.sourceHash = source.contentHash,
+			.boundsMin = {min.x, min.y, min.z},
+			.boundsMax = {max.x, max.y, max.z},
+			.vertexStride = sizeof(Vertex),
+			.attributeCount = VERTEX_LAYOUT.size(),
+			.vertexCount = mesh.vertices.size(),
+			.indexCount = mesh.indices.size(),
+			.vertexOffset = vertexOffset,
+			.indexOffset = indexOffset,
+			.indexStride = indexStride,
+			.lodCount = static_cast<uint32_t>(mesh.lods.size()),
+			.meshletCount = static_cast<uint32_t>(mesh.meshlets.size()),
+			.padding = 0
+		};
+
+		std::vector<char> data(indexOffset + mesh.indices.size() * indexStride, 0);
+		memcpy(data.data(), &header, sizeof(header));
+		memcpy(data.data() + sizeof(header), VERTEX_LAYOUT.data(), sizeof(VERTEX_LAYOUT));
+		if (lodBytes > 0)
+			memcpy(data.data() + sizeof(header) + sizeof(VERTEX_LAYOUT), mesh.lods.data(), lodBytes);
+		if (meshletBytes > 0)
+			memcpy(data.data() + meshletOffset, mesh.meshlets.data(), meshletBytes);
+		memcpy(data.data() + vertexOffset, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+		if (mesh.indexType == IndexType::Uint16) {
+			const std::vector<uint16_t> narrow(mesh.indices.begin(), mesh.indices.end());
+			memcpy(data.data() + indexOffset, narrow.data(), narrow.size() * sizeof(uint16_t));
+		} else {
+			memcpy(data.data() + indexOffset, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories(cacheFile.parent_path(), error);
+
+		// Write next to the destination and rename, so a crash never leaves a truncated cache behind. The
+		// temporary name is unique per write, threads or processes saving the same mesh never share a file.
+		std::filesystem::path tmpPath = cacheFile;
+		tmpPath += temporarySuffix();
+		{
+			std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				std::cout << "[ASTRO CORE] [UTILS] [MESH CACHE] failed to write mesh cache: " << tmpPath << std::endl;
+				return;
+			}
+			file.write(data.data(), static_cast<std::streamsize>(data.size()));
+		}
+
+		std::filesystem::rename(tmpPath, cacheFile, error);
+		if (error) {
+			std::cout << "[ASTRO CORE] [UTILS] [MESH CACHE] failed to save mesh cache: " << error.message() << std::endl;
+			std::filesystem::remove(tmpPath, error);
+		}
+	}
+}
@@ -0,0 +1,309 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/MeshOptimizer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Core::Utils {
+
+	// region Analysis
+	// Resolution of each overdraw view, enough to tell orderings apart without costing more than the load
+	static constexpr uint32_t OVERDRAW_GRID = 256;
+
+	struct OverdrawView {
+		std::vector<float> depth = std::vector<float>(OVERDRAW_GRID * OVERDRAW_GRID, std::numeric_limits<float>::infinity());
+		uint64_t shaded = 0;
+	};
+
+	static float edge(const glm::vec3& a, const glm::vec3& b, float x, float y) {
+		return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+	}
+
+	// Counter clockwise triangles only, in pixel coordinates with depth in z
+	static void rasterize(OverdrawView& view, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+		const float area = edge(a, b, c.x, c.y);
+		if (area <= 0.0f)
+			return;
+
+		const auto last = static_cast<float>(OVERDRAW_GRID - 1);
+		const auto minX = static_cast<uint32_t>(std::clamp(std::floor(std::min({a.x, b.x, c.x})), 0.0f, last));
+		const auto maxX = static_cast<uint32_t>(std::clamp(std::ceil(std::max({a.x, b.x, c.x})), 0.0f, last));
+		const auto minY = static_cast<uint32_t>(std::clamp(std::floor(std::min({a.y, b.y, c.y})), 0.0f, last));
+		const auto maxY = static_cast<uint32_t>(std::clamp(std::ceil(std::max({a.y, b.y, c.y})), 0.0f, last));
+
+		for (uint32_t y = minY; y <= maxY; y++) {
+			for (uint32_t x = minX; x <= maxX; x++) {
+				const float px = static_cast<float>(x) + 0.5f;
+				const float py = static_cast<float>(y) + 0.5f;
+				const float w0 = edge(b, c, px, py);
+				const float w1 = edge(c, a, px, py);
+				const float w2 = edge(a, b, px, py);
+				if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+					continue;
+
+				const float z = (w0 * a.z + w1 * b.z + w2 * c.z) / area;
+				float& depth = view.depth[y * OVERDRAW_GRID + x];
+				if (z < depth) {
+					depth = z;
+					view.shaded++;
+				}
+			}
+		}
+	}
+	// endregion
+
+	VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+		if (indices.empty() || vertexCount == 0)
+			return {};
+
+		// A FIFO cache holds the vertices of the last cacheSize misses
+		std::vector<uint64_t> missTime(vertexCount, 0);
+		uint64_t misses = 0;
+		for (const uint32_t index : indices) {
+			if (missTime[index] == 0 || misses - missTime[index] >= cacheSize) {
+				misses++;
+				missTime[index] = misses;
+			}
+		}
+
+		return VertexCacheStats{
+			.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3),
+			.atvr = static_cast<float>(misses) / static_cast<float>(vertexCount)
+		};
+	}
+
+	float analyzeOverdraw(std::span<const uint32_t> indices, std::span<const Vertex> vertices) {
+		if (indices.empty())
+			return 0.0f;
+
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+		for (const Vertex& vertex : vertices) {
+			min = glm::min(min, vertex.pos);
+			max = glm::max(max, vertex.pos);
+		}
+		const glm::vec3 size = max - min;
+		const float extent = std::max({size.x, size.y, size.z, std::numeric_limits<float>::min()});
+
+		uint64_t shaded = 0;
+		uint64_t covered = 0;
+
+		// Looking down each axis from both sides, mirroring u so the far side keeps counter clockwise fronts.
+		// u x v is the axis, so the unflipped view looks from the positive side where depth grows downwards.
+		for (int axis = 0; axis < 3; axis++) {
+			const int u = (axis + 1) % 3;
+			const int v = (axis + 2) % 3;
+
+			for (const bool flip : {false, true}) {
+				OverdrawView view;
+				auto project = [&](uint32_t index) {
+					const glm::vec3 p = (vertices[index].pos - min) / extent;
+					const float x = flip ? 1.0f - p[u] : p[u];
+					const float z = flip ? p[axis] : 1.0f - p[axis];
+					return glm::vec3(x * OVERDRAW_GRID, p[v] * OVERDRAW_GRID, z);
+				};
+
+				for (size_t i = 0; i + 2 < indices.size(); i += 3)
+					rasterize(view, project(indices[i]), project(indices[i + 1]), project(indices[i + 2]));
+
+				shaded += view.shaded;
+				covered += std::ranges::count_if(view.depth, [](float depth) { return depth != std::numeric_limits<float>::infinity(); });
+			}
+		}
+
+		return covered ? static_cast<float>(shaded) / static_cast<float>(covered) : 0.0f;
+	}
+
+	std::vector<uint32_t> optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+		const size_t triangleCount = indices.size() / 3;
+		std::vector<uint32_t> clusters;
+		if (triangleCount == 0)
+			return clusters;
+
+		// Triangles around each vertex, and how many of them are still to be emitted
+		std::vector<uint32_t> liveCount(vertexCount, 0);
+		for (const uint32_t index : indices)
+			liveCount[index]++;
+
+		std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+		std::partial_sum(liveCount.begin(), liveCount.end(), adjacencyOffset.begin() + 1);
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		std::vector<uint64_t> cacheTime(vertexCount, 0);
+		uint64_t time = cacheSize + 1;
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32_t> deadEnds;
+		std::vector<uint32_t> candidates;
+		size_t cursor = 0;
+
+		std::vector<uint32_t> output;
+		output.reserve(indices.size());
+
+		// Most recent vertex of the emitted triangles still in use, then the next one in index order
+		auto skipDeadEnd = [&]() -> int64_t {
+			while (!deadEnds.empty()) {
+				const uint32_t vertex = deadEnds.back();
+				deadEnds.pop_back();
+				if (liveCount[vertex] > 0)
+					return vertex;
+			}
+			for (; cursor < vertexCount; cursor++)
+				if (liveCount[cursor] > 0)
+					return static_cast<int64_t>(cursor);
+			return -1;
+		};
+
+		int64_t fanning = skipDeadEnd();
+		clusters.push_back(0);
+
+		while (fanning >= 0) {
+			candidates.clear();
+
+			for (uint32_t a = adjacencyOffset[fanning]; a < adjacencyOffset[fanning + 1]; a++) {
+				const uint32_t triangle = adjacency[a];
+				if (emitted[triangle])
+					continue;
+
+				for (uint32_t corner = 0; corner < 3; corner++) {
+					const uint32_t vertex = indices[triangle * 3 + corner];
+					output.push_back(vertex);
+					deadEnds.push_back(vertex);
+					candidates.push_back(vertex);
+					liveCount[vertex]--;
+					if (time - cacheTime[vertex] > cacheSize)
+						cacheTime[vertex] = time++;
+				}
+				emitted[triangle] = true;
+			}
+
+			// Prefer the candidate that entered the cache earliest while it stays in the cache for its whole fan
+			int64_t next = -1;
+			int64_t bestPriority = -1;
+			for (const uint32_t vertex : candidates) {
+				if (liveCount[vertex] == 0)
+					continue;
+
+				int64_t priority = 0;
+				if (time - cacheTime[vertex] + 2 * liveCount[vertex] <= cacheSize)
+					priority = static_cast<int64_t>(time - cacheTime[vertex]);
+				if (priority > bestPriority) {
+					bestPriority = priority;
+					next = vertex;
+				}
+			}
+
+			if (next < 0) {
+				next = skipDeadEnd();
+				if (next >= 0)
+					clusters.push_back(static_cast<uint32_t>(output.size() / 3));
+			}
+			fanning = next;
+		}
+
+		indices = std::move(output);
+		return clusters;
+	}
+
+	void optimizeOverdraw(std::vector<uint32_t>& indices, std::span<const Vertex> vertices, std::span<const uint32_t> clusters,
+	                      float threshold, uint32_t cacheSize) {
+		const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+		if (clusters.size() < 2)
+			return;
+
+		struct Cluster {
+			uint32_t first;
+			uint32_t last;
+			float sortKey;
+		};
+
+		// Area weighted centroid and normal of every cluster, and of the mesh
+		std::vector<Cluster> sorted(clusters.size());
+		std::vector<glm::vec3> centroids(clusters.size(), glm::vec3(0.0f));
+		std::vector<glm::vec3> normals(clusters.size(), glm::vec3(0.0f));
+		glm::vec3 meshCentroid(0.0f);
+		float meshArea = 0.0f;
+
+		for (size_t c = 0; c < clusters.size(); c++) {
+			sorted[c].first = clusters[c];
+			sorted[c].last = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+			float clusterArea = 0.0f;
+			for (uint32_t t = sorted[c].first; t < sorted[c].last; t++) {
+				const glm::vec3& p0 = vertices[indices[t * 3 + 0]].pos;
+				const glm::vec3& p1 = vertices[indices[t * 3 + 1]].pos;
+				const glm::vec3& p2 = vertices[indices[t * 3 + 2]].pos;
+				const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0); // twice the area
+				const float area = glm::length(normal);
+
+				centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+				normals[c] += normal;
+				clusterArea += area;
+			}
+
+			meshCentroid += centroids[c];
+			meshArea += clusterArea;
+			if (clusterArea > 0.0f)
+				centroids[c] /= clusterArea;
+		}
+		if (meshArea > 0.0f)
+			meshCentroid /= meshArea;
+
+		// Clusters far out along their own normal occlude the others, they are drawn first
+		for (size_t c = 0; c < clusters.size(); c++) {
+			const float length = glm::length(normals[c]);
+			sorted[c].sortKey = length > 0.0f ? glm::dot(centroids[c] - meshCentroid, normals[c] / length) : 0.0f;
+		}
+		std::ranges::stable_sort(sorted, std::greater{}, &Cluster::sortKey);
+
+		std::vector<uint32_t> reordered;
+		reordered.reserve(indices.size());
+		for (const Cluster& cluster : sorted)
+			reordered.insert(reordered.end(), indices.begin() + cluster.first * 3, indices.begin() + cluster.last * 3);
+
+		const float acmr = analyzeVertexCache(indices, vertices.size(), cacheSize).acmr;
+		if (analyzeVertexCache(reordered, vertices.size(), cacheSize).acmr <= acmr * threshold)
+			indices = std::move(reordered);
+	}
+
+	void optimizeVertexFetch(MeshData &mesh) {
+		constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+		std::vector<uint32_t> remap(mesh.vertices.size(), unused);
+		std::vector<Vertex> vertices;
+		vertices.reserve(mesh.vertices.size());
+
+		for (uint32_t& index : mesh.indices) {
+			if (remap[index] == unused) {
+				remap[index] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(mesh.vertices[index]);
+			}
+			index = remap[index];
+		}
+
+		mesh.vertices = std::move(vertices);
+	}
+
+	MeshOptimizationStats optimizeMesh(MeshData &mesh) {
+		MeshOptimizationStats stats;
+		stats.cacheBefore = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+		stats.overdrawBefore = analyzeOverdraw(mesh.indices, mesh.vertices);
+
+		const std::vector<uint32_t> clusters = optimizeVertexCache(mesh.indices, mesh.vertices.size());
+		optimizeOverdraw(mesh.indices, mesh.vertices, clusters);
+		optimizeVertexFetch(mesh);
+
+		stats.cacheAfter = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+		stats.overdrawAfter = analyzeOverdraw(mesh.indices, mesh.vertices);
+		return stats;
+	}
+}
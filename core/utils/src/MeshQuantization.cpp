@@ -0,0 +1,112 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/MeshQuantization.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Core::Utils {
+
+	static int16_t toSnorm16(float value) {
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	static uint16_t toUnorm16(float value) {
+		return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+	}
+
+	VertexFormat chooseVertexFormat(const MeshData &mesh) {
+		bool unitTexCoords = true;
+		for (const Vertex& vertex : mesh.vertices) {
+			if (vertex.color != glm::vec3(1.0f))
+				return VertexFormat::Full;
+			unitTexCoords &= vertex.texCoord.x >= 0.0f && vertex.texCoord.x <= 1.0f &&
+			                 vertex.texCoord.y >= 0.0f && vertex.texCoord.y <= 1.0f;
+		}
+		return unitTexCoords ? VertexFormat::Quantized : VertexFormat::QuantizedHalfUv;
+	}
+
+	uint16_t floatToHalf(float value) {
+		const uint32_t bits = std::bit_cast<uint32_t>(value);
+		const uint32_t sign = bits >> 16 & 0x8000u;
+		const uint32_t absolute = bits & 0x7fffffffu;
+
+		if (absolute >= 0x7f800000u) // infinity keeps its sign, NaN stays a quiet NaN
+			return static_cast<uint16_t>(sign | 0x7c00u | (absolute > 0x7f800000u ? 0x200u : 0u));
+		if (absolute >= 0x477ff000u) // rounds past the largest half
+			return static_cast<uint16_t>(sign | 0x7c00u);
+		if (absolute < 0x38800000u) { // subnormal half, round to nearest even on the shifted mantissa
+			const float magnitude = std::bit_cast<float>(absolute) * 16777216.0f; // 2^24, one unit per subnormal step
+			return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(magnitude)));
+		}
+
+		// Rebias the exponent and round the 13 dropped mantissa bits to nearest even
+		const uint32_t rebiased = absolute - 0x38000000u;
+		const uint32_t rounded = rebiased + 0xfffu + (rebiased >> 13 & 1u);
+		return static_cast<uint16_t>(sign | rounded >> 13);
+	}
+
+	glm::vec2 encodeOctahedral(glm::vec3 normal) {
+		const float norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (norm == 0.0f)
+			return glm::vec2(0.0f);
+
+		normal /= norm;
+		glm::vec2 encoded(normal.x, normal.y);
+		if (normal.z < 0.0f) {
+			// Lower hemisphere folded over the diagonals
+			encoded = glm::vec2((1.0f - std::abs(normal.y)) * (normal.x >= 0.0f ? 1.0f : -1.0f),
+			                    (1.0f - std::abs(normal.x)) * (normal.y >= 0.0f ? 1.0f : -1.0f));
+		}
+		return encoded;
+	}
+
+	QuantizedMesh quantizeMesh(const MeshData &mesh, VertexFormat format) {
+		if (format == VertexFormat::Full)
+			throw std::runtime_error("quantizeMesh needs a quantized vertex format");
+
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+		for (const Vertex& vertex : mesh.vertices) {
+			min = glm::min(min, vertex.pos);
+			max = glm::max(max, vertex.pos);
+		}
+
+		QuantizedMesh quantized;
+		quantized.format = format;
+		quantized.offset = (min + max) * 0.5f;
+		// Flat axes keep a non zero scale so the decoding matrix stays invertible
+		quantized.scale = glm::max((max - min) * 0.5f, glm::vec3(std::numeric_limits<float>::min()));
+		quantized.vertices.resize(mesh.vertices.size());
+
+		for (size_t i = 0; i < mesh.vertices.size(); i++) {
+			const Vertex& vertex = mesh.vertices[i];
+			QuantizedVertex& out = quantized.vertices[i];
+
+			const glm::vec3 position = (vertex.pos - quantized.offset) / quantized.scale;
+			out.pos[0] = toSnorm16(position.x);
+			out.pos[1] = toSnorm16(position.y);
+			out.pos[2] = toSnorm16(position.z);
+			out.pos[3] = 0;
+
+			const glm::vec2 normal = encodeOctahedral(vertex.normal);
+			out.normal[0] = toSnorm16(normal.x);
+			out.normal[1] = toSnorm16(normal.y);
+
+			if (format == VertexFormat::Quantized) {
+				out.texCoord[0] = toUnorm16(vertex.texCoord.x);
+				out.texCoord[1] = toUnorm16(vertex.texCoord.y);
+			} else {
+				out.texCoord[0] = floatToHalf(vertex.texCoord.x);
+				out.texCoord[1] = floatToHalf(vertex.texCoord.y);
+			}
+		}
+
+		return quantized;
+	}
+}
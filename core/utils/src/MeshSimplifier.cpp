@@ -0,0 +1,461 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/MeshSimplifier.hpp>
+#include <core/utils/FlatHashMap.hpp>
+#include <core/utils/Hash.hpp>
+#include <core/utils/MeshOptimizer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Core::Utils {
+
+	static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+	// Marks a vertex with more than one open edge leaving or entering it
+	static constexpr uint32_t CONFLICT = NONE - 1;
+
+	// Open edges pull their vertices back this much harder than faces, so borders and seams keep their shape
+	static constexpr double BORDER_WEIGHT = 10.0;
+	// Cost of changing texture coordinates or normals, relative to a squared distance of the bounds diagonal
+	static constexpr double ATTRIBUTE_WEIGHT = 0.01;
+
+	// region Quadrics
+	// Symmetric 4x4 matrix of the summed squared plane distances, weighted by area
+	struct Quadric {
+		double a00 = 0.0, a11 = 0.0, a22 = 0.0, a10 = 0.0, a20 = 0.0, a21 = 0.0;
+		double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+		double c = 0.0;
+		double weight = 0.0;
+
+		Quadric& operator+=(const Quadric& other) {
+			a00 += other.a00; a11 += other.a11; a22 += other.a22;
+			a10 += other.a10; a20 += other.a20; a21 += other.a21;
+			b0 += other.b0; b1 += other.b1; b2 += other.b2;
+			c += other.c;
+			weight += other.weight;
+			return *this;
+		}
+	};
+
+	// Plane dot(normal, p) + distance = 0, normal of unit length
+	static Quadric planeQuadric(const glm::vec3& normal, float distance, double weight) {
+		const double x = normal.x, y = normal.y, z = normal.z, d = distance;
+		Quadric quadric;
+		quadric.a00 = x * x * weight;
+		quadric.a11 = y * y * weight;
+		quadric.a22 = z * z * weight;
+		quadric.a10 = y * x * weight;
+		quadric.a20 = z * x * weight;
+		quadric.a21 = z * y * weight;
+		quadric.b0 = x * d * weight;
+		quadric.b1 = y * d * weight;
+		quadric.b2 = z * d * weight;
+		quadric.c = d * d * weight;
+		quadric.weight = weight;
+		return quadric;
+	}
+
+	// Mean squared distance of p to the planes
+	static double evaluate(const Quadric& quadric, const glm::vec3& p) {
+		const double x = p.x, y = p.y, z = p.z;
+		const double rx = quadric.a00 * x + quadric.a10 * y + quadric.a20 * z;
+		const double ry = quadric.a10 * x + quadric.a11 * y + quadric.a21 * z;
+		const double rz = quadric.a20 * x + quadric.a21 * y + quadric.a22 * z;
+		const double error = rx * x + ry * y + rz * z + 2.0 * (quadric.b0 * x + quadric.b1 * y + quadric.b2 * z) + quadric.c;
+		return quadric.weight > 0.0 ? std::abs(error) / quadric.weight : 0.0;
+	}
+	// endregion
+
+	// region Topology
+	struct PositionKey {
+		uint32_t x, y, z;
+		bool operator==(const PositionKey&) const = default;
+	};
+
+	struct PositionKeyHash {
+		size_t operator()(const PositionKey& key) const {
+			return static_cast<size_t>(mix64((static_cast<uint64_t>(key.x) << 32 | key.y) + mix64(key.z)));
+		}
+	};
+
+	struct EdgeHash {
+		size_t operator()(uint64_t edge) const { return static_cast<size_t>(mix64(edge)); }
+	};
+
+	static uint64_t edgeKey(uint32_t from, uint32_t to) {
+		return static_cast<uint64_t>(from) << 32 | to;
+	}
+
+	// Every vertex mapped to the first vertex sharing its position: wedges of one position only differ by
+	// their attributes
+	static std::vector<uint32_t> buildPositionRemap(std::span<const Vertex> vertices) {
+		std::vector<uint32_t> remap(vertices.size());
+		FlatHashMap<PositionKey, uint32_t, PositionKeyHash> firstVertex(vertices.size());
+		for (uint32_t i = 0; i < vertices.size(); i++) {
+			const glm::vec3& pos = vertices[i].pos;
+			// +0 folds -0 onto 0 so both bit patterns land on the same key
+			const PositionKey key{std::bit_cast<uint32_t>(pos.x + 0.0f), std::bit_cast<uint32_t>(pos.y + 0.0f),
+			                      std::bit_cast<uint32_t>(pos.z + 0.0f)};
+			remap[i] = firstVertex.tryEmplace(key, i).first;
+		}
+		return remap;
+	}
+
+	// Triangles around each vertex, in compressed rows
+	struct Adjacency {
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+
+		[[nodiscard]] std::span<const uint32_t> around(uint32_t vertex) const {
+			return {triangles.data() + offsets[vertex], triangles.data() + offsets[vertex + 1]};
+		}
+	};
+
+	static void buildAdjacency(Adjacency& adjacency, std::span<const uint32_t> indices, size_t vertexCount) {
+		adjacency.offsets.assign(vertexCount + 1, 0);
+		for (uint32_t index : indices)
+			adjacency.offsets[index + 1]++;
+		std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+		adjacency.triangles.resize(indices.size());
+		std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++)
+			adjacency.triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+	}
+
+	// An edge without its reverse is open: a mesh border, or one side of a seam since the wedges on the
+	// other side are different vertices. loop follows the open edge leaving a vertex, loopback the one
+	// entering it. Edges used twice in the same direction are non manifold and lock their vertices.
+	static void buildOpenEdges(std::vector<uint32_t>& loop, std::vector<uint32_t>& loopback, std::span<const uint32_t> indices) {
+		std::ranges::fill(loop, NONE);
+		std::ranges::fill(loopback, NONE);
+
+		FlatHashMap<uint64_t, uint32_t, EdgeHash> edges(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3)
+			for (size_t e = 0; e < 3; e++)
+				edges.tryEmplace(edgeKey(indices[i + e], indices[i + (e + 1) % 3]), 0).first++;
+
+		const auto link = [](uint32_t& slot, uint32_t vertex) {
+			slot = slot == NONE ? vertex : CONFLICT;
+		};
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (size_t e = 0; e < 3; e++) {
+				const uint32_t from = indices[i + e];
+				const uint32_t to = indices[i + (e + 1) % 3];
+				if (*edges.find(edgeKey(from, to)) > 1) {
+					loop[from] = loopback[to] = CONFLICT;
+				} else if (!edges.find(edgeKey(to, from))) {
+					link(loop[from], to);
+					link(loopback[to], from);
+				}
+			}
+		}
+	}
+
+	enum class VertexKind : uint8_t {
+		Manifold, // interior vertex with a single wedge, collapses anywhere
+		Border,   // on a mesh border, collapses along it onto another border vertex
+		Seam,     // two wedges on a seam, collapses along it with both wedges
+		Locked    // corners, seam ends, non manifold vertices
+	};
+
+	// Kind of every position, stored at its remapped vertex. seamPair links the two wedges of a seam.
+	static void classifyVertices(std::vector<VertexKind>& kinds, std::vector<uint32_t>& seamPair,
+	                             std::span<const uint32_t> indices, std::span<const uint32_t> remap,
+	                             std::span<const uint32_t> loop, std::span<const uint32_t> loopback) {
+		const size_t vertexCount = remap.size();
+		std::vector<uint32_t> firstWedge(vertexCount, NONE);
+		std::vector<uint32_t> secondWedge(vertexCount, NONE);
+		std::vector<uint32_t> wedgeCount(vertexCount, 0);
+		std::vector<uint8_t> referenced(vertexCount, 0);
+
+		for (uint32_t index : indices) {
+			if (referenced[index])
+				continue;
+			referenced[index] = 1;
+
+			const uint32_t position = remap[index];
+			if (wedgeCount[position]++ == 0)
+				firstWedge[position] = index;
+			else
+				secondWedge[position] = index;
+		}
+
+		const auto valid = [](uint32_t link) { return link != NONE && link != CONFLICT; };
+		std::ranges::fill(seamPair, NONE);
+
+		for (uint32_t position = 0; position < vertexCount; position++) {
+			VertexKind kind = VertexKind::Locked;
+			const uint32_t a = firstWedge[position];
+			const uint32_t b = secondWedge[position];
+
+			if (wedgeCount[position] == 1) {
+				if (loop[a] == NONE && loopback[a] == NONE)
+					kind = VertexKind::Manifold;
+				else if (valid(loop[a]) && valid(loopback[a]))
+					kind = VertexKind::Border;
+			} else if (wedgeCount[position] == 2 && valid(loop[a]) && valid(loopback[a]) && valid(loop[b]) && valid(loopback[b])) {
+				// Both sides run along the same positions in opposite directions
+				if (remap[loop[a]] == remap[loopback[b]] && remap[loopback[a]] == remap[loop[b]]) {
+					kind = VertexKind::Seam;
+					seamPair[a] = b;
+					seamPair[b] = a;
+				}
+			}
+			kinds[position] = kind;
+		}
+	}
+	// endregion
+
+	// region Collapse
+	struct Collapse {
+		uint32_t from;
+		uint32_t to;
+		double error;
+	};
+
+	static glm::vec3 faceNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+		return glm::cross(b - a, c - a);
+	}
+
+	// Whether moving the wedge from onto the position of to turns any remaining triangle around it over
+	static bool flipsTriangles(uint32_t from, uint32_t to, std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+	                           std::span<const uint32_t> remap, const Adjacency& adjacency) {
+		const glm::vec3& target = vertices[to].pos;
+		for (uint32_t triangle : adjacency.around(from)) {
+			const uint32_t* corners = &indices[triangle * 3];
+			if (remap[corners[0]] == remap[to] || remap[corners[1]] == remap[to] || remap[corners[2]] == remap[to])
+				continue; // removed by the collapse
+
+			glm::vec3 moved[3] = {vertices[corners[0]].pos, vertices[corners[1]].pos, vertices[corners[2]].pos};
+			const glm::vec3 before = faceNormal(moved[0], moved[1], moved[2]);
+			for (size_t k = 0; k < 3; k++)
+				if (corners[k] == from)
+					moved[k] = target;
+			const glm::vec3 after = faceNormal(moved[0], moved[1], moved[2]);
+
+			if (glm::dot(before, after) <= 0.0f)
+				return true;
+		}
+		return false;
+	}
+
+	static double attributeError(const Vertex& from, const Vertex& to, double scale) {
+		const glm::vec2 texCoord = from.texCoord - to.texCoord;
+		const glm::vec3 normal = from.normal - to.normal;
+		return scale * (glm::dot(texCoord, texCoord) + 0.25 * glm::dot(normal, normal));
+	}
+	// endregion
+
+	std::vector<uint32_t> simplifyMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+	                                   size_t targetIndexCount, float maxError, float* error) {
+		std::vector<uint32_t> result(indices.begin(), indices.end());
+		double resultError = 0.0;
+		const size_t vertexCount = vertices.size();
+
+		const std::vector<uint32_t> remap = buildPositionRemap(vertices);
+
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+		for (uint32_t index : result) {
+			min = glm::min(min, vertices[index].pos);
+			max = glm::max(max, vertices[index].pos);
+		}
+		const double diagonal = result.empty() ? 0.0 : glm::length(max - min);
+		const double attributeScale = ATTRIBUTE_WEIGHT * diagonal * diagonal;
+		const double maxErrorSquared = static_cast<double>(maxError) * maxError;
+
+		std::vector<uint32_t> loop(vertexCount);
+		std::vector<uint32_t> loopback(vertexCount);
+		buildOpenEdges(loop, loopback, result);
+
+		// Quadrics live at the remapped vertex, shared by every wedge of a position
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < result.size(); i += 3) {
+			const glm::vec3& p0 = vertices[result[i]].pos;
+			const glm::vec3& p1 = vertices[result[i + 1]].pos;
+			const glm::vec3& p2 = vertices[result[i + 2]].pos;
+			glm::vec3 normal = faceNormal(p0, p1, p2);
+			const float doubleArea = glm::length(normal);
+			if (doubleArea == 0.0f)
+				continue;
+			normal /= doubleArea;
+
+			const Quadric face = planeQuadric(normal, -glm::dot(normal, p0), 0.5 * doubleArea);
+			for (size_t k = 0; k < 3; k++)
+				quadrics[remap[result[i + k]]] += face;
+
+			// Planes through open edges, perpendicular to their face
+			for (size_t e = 0; e < 3; e++) {
+				const uint32_t from = result[i + e];
+				const uint32_t to = result[i + (e + 1) % 3];
+				if (loop[from] != to)
+					continue;
+
+				const glm::vec3 edge = vertices[to].pos - vertices[from].pos;
+				const float length = glm::length(edge);
+				if (length == 0.0f)
+					continue;
+				const glm::vec3 borderNormal = glm::normalize(glm::cross(edge, normal));
+				const Quadric border = planeQuadric(borderNormal, -glm::dot(borderNormal, vertices[from].pos),
+				                                    BORDER_WEIGHT * length * length);
+				quadrics[remap[from]] += border;
+				quadrics[remap[to]] += border;
+			}
+		}
+
+		std::vector<VertexKind> kinds(vertexCount);
+		std::vector<uint32_t> seamPair(vertexCount);
+		std::vector<uint32_t> collapseRemap(vertexCount);
+		std::vector<uint8_t> locked(vertexCount);
+		std::vector<Collapse> collapses;
+		Adjacency adjacency;
+
+		// Each pass collapses the cheapest edges whose neighbourhoods do not overlap, then rebuilds the topology
+		while (result.size() > targetIndexCount) {
+			buildOpenEdges(loop, loopback, result);
+			classifyVertices(kinds, seamPair, result, remap, loop, loopback);
+			buildAdjacency(adjacency, result, vertexCount);
+
+			const auto canCollapse = [&](uint32_t from, uint32_t to) {
+				const VertexKind fromKind = kinds[remap[from]];
+				const VertexKind toKind = kinds[remap[to]];
+				const bool alongOpenEdge = loop[from] == to || loopback[from] == to;
+
+				switch (fromKind) {
+				case VertexKind::Manifold:
+					return true;
+				case VertexKind::Border:
+					return toKind == VertexKind::Border && alongOpenEdge;
+				case VertexKind::Seam: {
+					if (toKind != VertexKind::Seam || !alongOpenEdge)
+						return false;
+					// The wedges on the other side must be joined by the same seam edge
+					const uint32_t fromPair = seamPair[from];
+					const uint32_t toPair = seamPair[to];
+					return loop[fromPair] == toPair || loopback[fromPair] == toPair;
+				}
+				default:
+					return false;
+				}
+			};
+
+			const auto addCandidate = [&](uint32_t from, uint32_t to) {
+				if (remap[from] == remap[to] || !canCollapse(from, to))
+					return;
+
+				double cost = evaluate(quadrics[remap[from]], vertices[to].pos) + attributeError(vertices[from], vertices[to], attributeScale);
+				if (kinds[remap[from]] == VertexKind::Seam)
+					cost += attributeError(vertices[seamPair[from]], vertices[seamPair[to]], attributeScale);
+				collapses.push_back({from, to, cost});
+			};
+
+			// Interior edges show up once per direction in their two triangles, open edges only once
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3) {
+				for (size_t e = 0; e < 3; e++) {
+					const uint32_t from = result[i + e];
+					const uint32_t to = result[i + (e + 1) % 3];
+					addCandidate(from, to);
+					if (loop[from] == to)
+						addCandidate(to, from);
+				}
+			}
+			std::ranges::sort(collapses, {}, &Collapse::error);
+
+			std::iota(collapseRemap.begin(), collapseRemap.end(), 0u);
+			std::ranges::fill(locked, 0);
+			const size_t triangleCount = result.size() / 3;
+			const size_t removable = triangleCount - targetIndexCount / 3;
+			size_t removed = 0;
+
+			for (const Collapse& collapse : collapses) {
+				if (collapse.error > maxErrorSquared || removed >= removable)
+					break;
+
+				const uint32_t fromPosition = remap[collapse.from];
+				const uint32_t toPosition = remap[collapse.to];
+				if (locked[fromPosition] || locked[toPosition])
+					continue;
+
+				const bool seam = kinds[fromPosition] == VertexKind::Seam;
+				if (flipsTriangles(collapse.from, collapse.to, vertices, result, remap, adjacency) ||
+				    (seam && flipsTriangles(seamPair[collapse.from], seamPair[collapse.to], vertices, result, remap, adjacency)))
+					continue;
+
+				collapseRemap[collapse.from] = collapse.to;
+				if (seam)
+					collapseRemap[seamPair[collapse.from]] = seamPair[collapse.to];
+				quadrics[toPosition] += quadrics[fromPosition];
+
+				// Freeze the neighbourhood, the flip tests of later collapses in this pass must see final positions
+				for (const uint32_t wedge : {collapse.from, seam ? seamPair[collapse.from] : collapse.from})
+					for (uint32_t triangle : adjacency.around(wedge))
+						for (size_t k = 0; k < 3; k++)
+							locked[remap[result[triangle * 3 + k]]] = 1;
+
+				removed += kinds[fromPosition] == VertexKind::Border ? 1 : 2;
+				resultError = std::max(resultError, collapse.error);
+			}
+
+			if (removed == 0)
+				break;
+
+			// Triangles whose corners now share a position are gone
+			size_t write = 0;
+			for (size_t i = 0; i < result.size(); i += 3) {
+				const uint32_t a = collapseRemap[result[i]];
+				const uint32_t b = collapseRemap[result[i + 1]];
+				const uint32_t c = collapseRemap[result[i + 2]];
+				if (remap[a] == remap[b] || remap[b] == remap[c] || remap[c] == remap[a])
+					continue;
+				result[write++] = a;
+				result[write++] = b;
+				result[write++] = c;
+			}
+			result.resize(write);
+		}
+
+		if (error)
+			*error = static_cast<float>(std::sqrt(resultError));
+		return result;
+	}
+
+	void buildLodChain(MeshData &mesh, uint32_t lodCount) {
+		mesh.lods.assign(1, MeshLod{0, static_cast<uint32_t>(mesh.indices.size()), 0.0f});
+		if (mesh.indices.empty())
+			return;
+
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+		for (const Vertex& vertex : mesh.vertices) {
+			min = glm::min(min, vertex.pos);
+			max = glm::max(max, vertex.pos);
+		}
+		const float maxError = LOD_MAX_RELATIVE_ERROR * glm::length(max - min);
+
+		std::vector<uint32_t> previous = mesh.indices;
+		float error = 0.0f;
+		for (uint32_t level = 1; level < std::min(lodCount, MAX_MESH_LODS); level++) {
+			const size_t target = static_cast<size_t>(static_cast<float>(previous.size() / 3) * LOD_REDUCTION) * 3;
+
+			float levelError = 0.0f;
+			std::vector<uint32_t> lod = simplifyMesh(mesh.vertices, previous, target, maxError, &levelError);
+			if (lod.empty() || static_cast<float>(lod.size()) > static_cast<float>(previous.size()) * LOD_MIN_REDUCTION)
+				break;
+
+			optimizeVertexCache(lod, mesh.vertices.size());
+
+			// Each level is simplified from the previous one, their errors add up
+			error += levelError;
+			mesh.lods.push_back(MeshLod{static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(lod.size()), error});
+			mesh.indices.insert(mesh.indices.end(), lod.begin(), lod.end());
+			previous = std::move(lod);
+		}
+	}
+}
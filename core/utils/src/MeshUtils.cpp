@@ -2,98 +2,182 @@
 // Created by eharquin on 12/19/25.
 //
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <iostream>
 #include <stdexcept>
-#include <tiny_obj_loader.h>
-#include <unordered_map>
-
+#include <string_view>
+
+#include <core/utils/FlatHashMap.hpp>
+#include <core/utils/Hash.hpp>
+#include <core/utils/MappedFile.hpp>
+#include <core/utils/MeshletBuilder.hpp>
+#include <core/utils/MeshOptimizer.hpp>
+#include <core/utils/MeshSimplifier.hpp>
 #include <core/utils/MeshUtils.hpp>
+#include <core/utils/ObjParser.hpp>
+#include <core/utils/ThreadPool.hpp>
 
 namespace Core::Utils {
-	MeshData loadMesh(const std::string &filename) {
-		MeshData meshData;
+	// Vertices built per task once the unique corners are known
+	static constexpr uint32_t VERTEX_BATCH = 1 << 16;
+
+	// Optimized and simplified once after the parse, the cache stores the optimized order and the levels of detail
+	static MeshData loadOptimizedObj(const std::string &filename, ThreadPool *threads) {
+		MeshData meshData = loadObj(filename, threads);
+
+		const MeshOptimizationStats stats = optimizeMesh(meshData);
+		std::cout << "[ASTRO CORE] [UTILS] [MESH OPT] " << filename
+				<< ": ACMR " << stats.cacheBefore.acmr << " -> " << stats.cacheAfter.acmr
+				<< ", ATVR " << stats.cacheBefore.atvr << " -> " << stats.cacheAfter.atvr
+				<< ", overdraw " << stats.overdrawBefore << " -> " << stats.overdrawAfter << std::endl;
+
+		const auto start = std::chrono::steady_clock::now();
+		buildLodChain(meshData);
+		const double lodMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "[ASTRO CORE] [UTILS] [MESH LOD] " << filename << ": " << meshData.lods.size() << " levels in " << lodMs << " ms,";
+		for (const MeshLod& lod : meshData.lods)
+			std::cout << ' ' << lod.indexCount / 3 << " triangles (error " << lod.error << ")";
+		std::cout << std::endl;
+
+		const auto meshletStart = std::chrono::steady_clock::now();
+		buildMeshlets(meshData);
+		const double meshletMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - meshletStart).count();
+
+		std::cout << "[ASTRO CORE] [UTILS] [MESHLET] " << filename << ": " << meshData.meshlets.size() << " meshlets in "
+				<< meshletMs << " ms" << std::endl;
+		return meshData;
+	}
 
-		tinyobj::attrib_t                attrib;
-		std::vector<tinyobj::shape_t>    shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string                      warn, err;
+	MeshData loadMesh(const std::string &filename, const std::string &cacheDir, ThreadPool *threads) {
+		if (cacheDir.empty())
+			return loadOptimizedObj(filename, threads);
 
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filename.c_str()))
-			throw std::runtime_error(warn + err);
+		const std::filesystem::path cacheFile = meshCachePath(filename, cacheDir);
+		if (std::optional<MeshData> cached = readMeshCache(cacheFile, filename))
+			return std::move(*cached);
 
-		std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+		// Identify the source before parsing it, a change during the parse then invalidates the cache
+		MeshSource source = describeMeshSource(filename);
+		source.contentHash = hashMeshSource(filename);
 
-		for (const auto &shape : shapes)
+		MeshData meshData = loadOptimizedObj(filename, threads);
+		writeMeshCache(cacheFile, meshData, source);
+
+		std::cout << "[ASTRO CORE] [UTILS] [MESH CACHE] " << filename << " cached to " << cacheFile.string() << std::endl;
+		return meshData;
+	}
+
+	MeshData loadObj(const std::string &filename, ThreadPool *threads) {
+		const auto start = std::chrono::steady_clock::now();
+
+		ObjData obj;
+		size_t fileSize;
 		{
-			for (size_t f = 0; f < shape.mesh.indices.size(); f += 3) {
-				std::array<uint32_t,3> faceIndices;
-
-				for (size_t k = 0; k < 3; ++k) {
-					auto index = shape.mesh.indices[f + k];
-					Vertex vertex{};
-
-					// position
-					vertex.pos = {
-						attrib.vertices[3 * index.vertex_index + 0],
-						attrib.vertices[3 * index.vertex_index + 1],
-						attrib.vertices[3 * index.vertex_index + 2]
+			const MappedFile file(filename);
+			fileSize = file.size();
+			obj = parseObj(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()), threads);
+		}
+
+		const auto parsed = std::chrono::steady_clock::now();
+
+		MeshData meshData;
+
+		// Closed meshes have about half as many vertices as faces, seams add some back
+		const size_t cornerCount = obj.corners.size();
+		FlatHashMap<ObjCorner, uint32_t, ObjCornerHash> uniqueVertices(cornerCount / 3);
+		std::vector<ObjCorner> uniqueCorners;
+		uniqueCorners.reserve(cornerCount / 3);
+		meshData.indices.reserve(cornerCount);
+
+		// deduplicate vertices on their OBJ indices, a single probe per corner
+		for (const ObjCorner& corner : obj.corners) {
+			const auto [slot, inserted] = uniqueVertices.tryEmplace(corner, static_cast<uint32_t>(uniqueCorners.size()));
+			if (inserted)
+				uniqueCorners.push_back(corner);
+			meshData.indices.push_back(slot);
+		}
+
+		meshData.vertices.resize(uniqueCorners.size());
+		auto buildVertices = [&](uint32_t batch) {
+			const size_t first = static_cast<size_t>(batch) * VERTEX_BATCH;
+			const size_t last = std::min(first + VERTEX_BATCH, uniqueCorners.size());
+
+			for (size_t i = first; i < last; i++) {
+				const ObjCorner& index = uniqueCorners[i];
+				Vertex& vertex = meshData.vertices[i];
+
+				// position
+				vertex.pos = {
+					obj.positions[3 * index.vertex + 0],
+					obj.positions[3 * index.vertex + 1],
+					obj.positions[3 * index.vertex + 2]
+				};
+
+				// texcoord
+				if (index.texCoord >= 0)
+					vertex.texCoord = {
+						obj.texCoords[2 * index.texCoord + 0],
+						1.0f - obj.texCoords[2 * index.texCoord + 1]
 					};
+				else
+					vertex.texCoord = {0.0f, 0.0f};
+
+				// color
+				vertex.color = {1.0f, 1.0f, 1.0f};
+
+				// normal
+				if (index.normal >= 0)
+					vertex.normal = {
+						obj.normals[3 * index.normal + 0],
+						obj.normals[3 * index.normal + 1],
+						obj.normals[3 * index.normal + 2]
+					};
+				else
+					vertex.normal = glm::vec3(0.0f); // sera calculé plus tard
+			}
+		};
+
+		const auto batchCount = static_cast<uint32_t>((uniqueCorners.size() + VERTEX_BATCH - 1) / VERTEX_BATCH);
+		if (threads)
+			threads->parallelFor(batchCount, buildVertices);
+		else
+			for (uint32_t batch = 0; batch < batchCount; batch++)
+				buildVertices(batch);
 
-					// texcoord
-					if (index.texcoord_index >= 0)
-						vertex.texCoord = {
-							attrib.texcoords[2 * index.texcoord_index + 0],
-							1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-						};
-					else
-						vertex.texCoord = {0.0f, 0.0f};
-
-					// color
-					vertex.color = {1.0f, 1.0f, 1.0f};
-
-					// normal
-					if (index.normal_index >= 0)
-						vertex.normal = {
-							attrib.normals[3 * index.normal_index + 0],
-							attrib.normals[3 * index.normal_index + 1],
-							attrib.normals[3 * index.normal_index + 2]
-						};
-					else
-						vertex.normal = glm::vec3(0.0f); // sera calculé plus tard
-
-					// deduplicate vertices
-					if (!uniqueVertices.contains(vertex)) {
-						uniqueVertices[vertex] = static_cast<uint32_t>(meshData.vertices.size());
-						meshData.vertices.push_back(vertex);
-					}
-
-					faceIndices[k] = uniqueVertices[vertex];
-				}
-
-				meshData.indices.push_back(faceIndices[0]);
-				meshData.indices.push_back(faceIndices[1]);
-				meshData.indices.push_back(faceIndices[2]);
-
-				// calculer la normale si elle n'était pas fournie
-				if (attrib.normals.empty()) {
-					glm::vec3 p0 = meshData.vertices[faceIndices[0]].pos;
-					glm::vec3 p1 = meshData.vertices[faceIndices[1]].pos;
-					glm::vec3 p2 = meshData.vertices[faceIndices[2]].pos;
-
-					glm::vec3 n = glm::normalize(glm::cross(p1 - p0, p2 - p0));
-
-					for (auto idx : faceIndices)
-						meshData.vertices[idx].normal += n;
-				}
+		// calculer la normale si elle n'était pas fournie
+		if (obj.normals.empty()) {
+			for (size_t f = 0; f < meshData.indices.size(); f += 3) {
+				const std::array<uint32_t, 3> faceIndices = {meshData.indices[f], meshData.indices[f + 1], meshData.indices[f + 2]};
+
+				glm::vec3 p0 = meshData.vertices[faceIndices[0]].pos;
+				glm::vec3 p1 = meshData.vertices[faceIndices[1]].pos;
+				glm::vec3 p2 = meshData.vertices[faceIndices[2]].pos;
+
+				glm::vec3 n = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+
+				for (auto idx : faceIndices)
+					meshData.vertices[idx].normal += n;
 			}
-		}
 
-		// normaliser les normales si calculées
-		if (attrib.normals.empty()) {
+			// normaliser les normales si calculées
 			for (auto &v : meshData.vertices)
 				v.normal = glm::normalize(v.normal);
 		}
 
+		// Small props fit 16 bit indices, halving their index memory in the cache and on the GPU
+		meshData.indexType = smallestIndexType(meshData.vertices.size());
+
+		const auto end = std::chrono::steady_clock::now();
+		const double parseMs = std::chrono::duration<double, std::milli>(parsed - start).count();
+		const double totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+		std::cout << "[ASTRO CORE] [UTILS] [OBJ] " << filename << ": " << fileSize / (1024.0 * 1024.0) << " MB parsed in "
+				<< parseMs << " ms (" << fileSize / (1024.0 * 1024.0) / (parseMs / 1000.0) << " MB/s) on "
+				<< (threads ? threads->size() + 1 : 1) << " threads, " << meshData.vertices.size() << " vertices and "
+				<< meshData.indices.size() / 3 << " triangles in " << totalMs << " ms" << std::endl;
+
 		return meshData;
 	}
-}
\ No newline at end of file
+}
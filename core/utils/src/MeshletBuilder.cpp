@@ -0,0 +1,218 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/MeshletBuilder.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Core::Utils {
+
+	static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+	// Weight of facing away from the meshlet's average normal, relative to one more vertex
+	static constexpr float NORMAL_WEIGHT = 0.5f;
+	// Bonus of using the last triangle of a vertex, relative to one more vertex
+	static constexpr float CLOSED_WEIGHT = 0.5f;
+	// Below this smallest cosine to the average normal the cone is too wide to ever cull
+	static constexpr float CONE_MIN_COSINE = 0.1f;
+
+	// region Bounds
+	static glm::vec3 triangleNormal(std::span<const Vertex> vertices, const uint32_t* triangle) {
+		const glm::vec3 normal = glm::cross(vertices[triangle[1]].pos - vertices[triangle[0]].pos,
+		                                    vertices[triangle[2]].pos - vertices[triangle[0]].pos);
+		const float length = glm::length(normal);
+		return length > 0.0f ? normal / length : glm::vec3(0.0f);
+	}
+
+	static void computeBounds(Meshlet& meshlet, std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+	                          std::span<const glm::vec3> normals) {
+		const uint32_t* triangles = indices.data() + meshlet.firstIndex;
+
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+		for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++) {
+			min = glm::min(min, vertices[triangles[i]].pos);
+			max = glm::max(max, vertices[triangles[i]].pos);
+		}
+		const glm::vec3 center = (min + max) * 0.5f;
+		float radius = 0.0f;
+		for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++)
+			radius = std::max(radius, glm::length(vertices[triangles[i]].pos - center));
+		meshlet.boundingSphere = glm::vec4(center, radius);
+
+		const uint32_t firstTriangle = meshlet.firstIndex / 3;
+		glm::vec3 axis(0.0f);
+		for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+			axis += normals[firstTriangle + t];
+		const float length = glm::length(axis);
+		meshlet.cone = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		if (length <= 0.0f)
+			return;
+		axis /= length;
+
+		// Degenerate triangles face nowhere and do not widen the cone
+		float minCosine = 1.0f;
+		for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+			if (normals[firstTriangle + t] != glm::vec3(0.0f))
+				minCosine = std::min(minCosine, glm::dot(normals[firstTriangle + t], axis));
+		if (minCosine <= CONE_MIN_COSINE)
+			return;
+		meshlet.cone = glm::vec4(axis, std::sqrt(1.0f - minCosine * minCosine));
+	}
+	// endregion
+
+	std::vector<Meshlet> buildMeshlets(std::span<const Vertex> vertices, std::span<uint32_t> indices,
+	                                   uint32_t maxVertices, uint32_t maxTriangles) {
+		const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+		if (triangleCount == 0)
+			return {};
+		maxVertices = std::max(maxVertices, 3u);
+		maxTriangles = std::max(maxTriangles, 1u);
+
+		std::vector<uint32_t> offsets(vertices.size() + 1, 0);
+		for (uint32_t index : indices)
+			offsets[index + 1]++;
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		std::vector<uint32_t> adjacency(triangleCount * 3);
+		std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+		for (uint32_t i = 0; i < triangleCount * 3; i++)
+			adjacency[cursor[indices[i]]++] = i / 3;
+
+		std::vector<glm::vec3> normals(triangleCount);
+		for (uint32_t t = 0; t < triangleCount; t++)
+			normals[t] = triangleNormal(vertices, &indices[t * 3]);
+
+		// Stamps hold the meshlet that last used a vertex or listed a candidate, so nothing is cleared per meshlet
+		std::vector<uint32_t> vertexStamp(vertices.size(), NONE);
+		std::vector<uint32_t> candidateStamp(triangleCount, NONE);
+		std::vector<uint8_t> emitted(triangleCount, 0);
+		std::vector<uint32_t> order;
+		order.reserve(triangleCount);
+		std::vector<uint32_t> candidates;
+		std::vector<Meshlet> meshlets;
+
+		// Unemitted triangles around each vertex
+		std::vector<uint32_t> live(vertices.size());
+		for (uint32_t v = 0; v < vertices.size(); v++)
+			live[v] = offsets[v + 1] - offsets[v];
+
+		uint32_t scanCursor = 0;
+		while (true) {
+			// The next meshlet starts next to the previous one, at its most enclosed leftover, so the remaining
+			// surface is eaten from its edge instead of left in holes. The input order is the fallback.
+			uint32_t seed = NONE;
+			uint32_t seedLive = NONE;
+			for (uint32_t triangle : candidates) {
+				if (emitted[triangle])
+					continue;
+				const uint32_t triangleLive = live[indices[triangle * 3]] + live[indices[triangle * 3 + 1]] + live[indices[triangle * 3 + 2]];
+				if (triangleLive < seedLive) {
+					seedLive = triangleLive;
+					seed = triangle;
+				}
+			}
+			if (seed == NONE) {
+				while (scanCursor < triangleCount && emitted[scanCursor])
+					scanCursor++;
+				if (scanCursor == triangleCount)
+					break;
+				seed = scanCursor;
+			}
+
+			const auto id = static_cast<uint32_t>(meshlets.size());
+			Meshlet& meshlet = meshlets.emplace_back();
+			meshlet.firstIndex = static_cast<uint32_t>(order.size() * 3);
+			glm::vec3 normalSum(0.0f);
+			candidates.clear();
+
+			auto add = [&](uint32_t triangle) {
+				emitted[triangle] = 1;
+				order.push_back(triangle);
+				for (uint32_t k = 0; k < 3; k++)
+					live[indices[triangle * 3 + k]]--;
+				meshlet.triangleCount++;
+				normalSum += normals[triangle];
+				for (uint32_t k = 0; k < 3; k++) {
+					const uint32_t vertex = indices[triangle * 3 + k];
+					if (vertexStamp[vertex] == id)
+						continue;
+					vertexStamp[vertex] = id;
+					meshlet.vertexCount++;
+					for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; i++) {
+						const uint32_t neighbour = adjacency[i];
+						if (!emitted[neighbour] && candidateStamp[neighbour] != id) {
+							candidateStamp[neighbour] = id;
+							candidates.push_back(neighbour);
+						}
+					}
+				}
+			};
+
+			add(seed);
+			while (meshlet.triangleCount < maxTriangles) {
+				const float length = glm::length(normalSum);
+				const glm::vec3 axis = length > 0.0f ? normalSum / length : glm::vec3(0.0f);
+
+				uint32_t best = NONE;
+				float bestScore = std::numeric_limits<float>::max();
+				for (size_t c = 0; c < candidates.size();) {
+					const uint32_t triangle = candidates[c];
+					if (emitted[triangle]) {
+						candidates[c] = candidates.back();
+						candidates.pop_back();
+						continue;
+					}
+					c++;
+
+					uint32_t newVertices = 0;
+					uint32_t closedVertices = 0;
+					for (uint32_t k = 0; k < 3; k++) {
+						const uint32_t vertex = indices[triangle * 3 + k];
+						newVertices += vertexStamp[vertex] != id;
+						closedVertices += live[vertex] == 1;
+					}
+					if (meshlet.vertexCount + newVertices > maxVertices)
+						continue;
+
+					// Triangles finishing a vertex come first, the vertex is then never loaded by another meshlet
+					const float score = static_cast<float>(newVertices) - static_cast<float>(closedVertices) * CLOSED_WEIGHT +
+					                    (1.0f - glm::dot(normals[triangle], axis)) * NORMAL_WEIGHT;
+					if (score < bestScore) {
+						bestScore = score;
+						best = triangle;
+					}
+				}
+				if (best == NONE)
+					break;
+				add(best);
+			}
+		}
+
+		std::vector<uint32_t> reordered;
+		reordered.reserve(indices.size());
+		for (uint32_t triangle : order)
+			reordered.insert(reordered.end(), &indices[triangle * 3], &indices[triangle * 3] + 3);
+		std::copy(reordered.begin(), reordered.end(), indices.begin());
+
+		std::vector<glm::vec3> orderedNormals(triangleCount);
+		for (uint32_t t = 0; t < triangleCount; t++)
+			orderedNormals[t] = normals[order[t]];
+		for (Meshlet& meshlet : meshlets)
+			computeBounds(meshlet, vertices, indices, orderedNormals);
+
+		return meshlets;
+	}
+
+	void buildMeshlets(MeshData &mesh) {
+		const MeshLod finest = mesh.lods.empty()
+			                       ? MeshLod{0, static_cast<uint32_t>(mesh.indices.size()), 0.0f}
+			                       : mesh.lods.front();
+		mesh.meshlets = buildMeshlets(mesh.vertices,
+		                              std::span(mesh.indices).subspan(finest.firstIndex, finest.indexCount));
+		for (Meshlet& meshlet : mesh.meshlets)
+			meshlet.firstIndex += finest.firstIndex;
+	}
+}
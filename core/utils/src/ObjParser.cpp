@@ -0,0 +1,250 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/ObjParser.hpp>
+#include <core/utils/ThreadPool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Core::Utils {
+
+	// region Chunk parsing
+	// Chunks below this size are not worth a task of their own
+	static constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
+	// More chunks than threads, so uneven chunks balance out through work stealing
+	static constexpr uint32_t CHUNKS_PER_THREAD = 4;
+
+	// Negative OBJ indices count back from the attributes seen so far, which a chunk only knows locally
+	struct RelativeIndex {
+		uint32_t corner;
+		uint32_t attribute; // 0 vertex, 1 normal, 2 texCoord
+	};
+
+	struct ObjChunk {
+		ObjData data;
+		std::vector<RelativeIndex> relative;
+	};
+
+	static bool isBlank(char c) {
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	static const char* skipBlanks(const char* p, const char* end) {
+		while (p < end && isBlank(*p))
+			p++;
+		return p;
+	}
+
+	static const char* parseFloat(const char* p, const char* end, float& value) {
+		p = skipBlanks(p, end);
+		if (p < end && *p == '+')
+			p++;
+		const auto [next, error] = std::from_chars(p, end, value);
+		if (error != std::errc())
+			throw std::runtime_error("malformed OBJ number near \"" + std::string(p, std::min<size_t>(end - p, 16)) + "\"");
+		return next;
+	}
+
+	// Reads count floats, extra components such as vertex colors or w are skipped
+	static void parseFloats(const char* p, const char* end, std::vector<float>& out, uint32_t count) {
+		for (uint32_t i = 0; i < count; i++) {
+			float value;
+			p = parseFloat(p, end, value);
+			out.push_back(value);
+		}
+	}
+
+	static const char* parseIndex(const char* p, const char* end, int32_t& value) {
+		const auto [next, error] = std::from_chars(p, end, value);
+		if (error != std::errc() || value == 0)
+			throw std::runtime_error("malformed OBJ face index near \"" + std::string(p, std::min<size_t>(end - p, 16)) + "\"");
+		return next;
+	}
+
+	// Polygon corner before fan triangulation, relative marks the attributes given as negative indices
+	struct PolygonCorner {
+		ObjCorner corner;
+		uint8_t relative;
+	};
+
+	static void parseFace(const char* p, const char* end, ObjChunk& chunk, std::vector<PolygonCorner>& polygon) {
+		const std::array<size_t, 3> counts = {
+			chunk.data.positions.size() / 3,
+			chunk.data.normals.size() / 3,
+			chunk.data.texCoords.size() / 2
+		};
+
+		// Positive indices are absolute, negative ones are resolved against the local counts here and
+		// shifted by the attributes of the previous chunks once they are known
+		auto resolve = [&](int32_t index, uint32_t attribute, uint8_t& relative) {
+			if (index > 0)
+				return index - 1;
+			relative |= static_cast<uint8_t>(1u << attribute);
+			return static_cast<int32_t>(counts[attribute]) + index;
+		};
+
+		polygon.clear();
+		while (true) {
+			p = skipBlanks(p, end);
+			if (p == end)
+				break;
+
+			PolygonCorner corner{{-1, -1, -1}, 0};
+			int32_t index;
+			p = parseIndex(p, end, index);
+			corner.corner.vertex = resolve(index, 0, corner.relative);
+
+			if (p < end && *p == '/') {
+				p++;
+				if (p < end && *p != '/') {
+					p = parseIndex(p, end, index);
+					corner.corner.texCoord = resolve(index, 2, corner.relative);
+				}
+				if (p < end && *p == '/') {
+					p++;
+					p = parseIndex(p, end, index);
+					corner.corner.normal = resolve(index, 1, corner.relative);
+				}
+			}
+			polygon.push_back(corner);
+		}
+
+		if (polygon.size() < 3)
+			throw std::runtime_error("OBJ face with fewer than three corners");
+
+		auto emit = [&](const PolygonCorner& corner) {
+			const auto cornerIndex = static_cast<uint32_t>(chunk.data.corners.size());
+			for (uint32_t attribute = 0; attribute < 3; attribute++)
+				if (corner.relative & 1u << attribute)
+					chunk.relative.push_back({cornerIndex, attribute});
+			chunk.data.corners.push_back(corner.corner);
+		};
+
+		for (size_t i = 1; i + 1 < polygon.size(); i++) {
+			emit(polygon[0]);
+			emit(polygon[i]);
+			emit(polygon[i + 1]);
+		}
+	}
+
+	static void parseChunk(const char* p, const char* end, ObjChunk& chunk) {
+		std::vector<PolygonCorner> polygon;
+
+		while (p < end) {
+			const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+			if (!lineEnd)
+				lineEnd = end;
+
+			p = skipBlanks(p, lineEnd);
+			if (lineEnd - p >= 2 && isBlank(p[1])) {
+				if (p[0] == 'v')
+					parseFloats(p + 1, lineEnd, chunk.data.positions, 3);
+				else if (p[0] == 'f')
+					parseFace(p + 1, lineEnd, chunk, polygon);
+			} else if (lineEnd - p >= 3 && p[0] == 'v' && isBlank(p[2])) {
+				if (p[1] == 'n')
+					parseFloats(p + 2, lineEnd, chunk.data.normals, 3);
+				else if (p[1] == 't')
+					parseFloats(p + 2, lineEnd, chunk.data.texCoords, 2);
+			}
+			// Comments, groups, objects, smoothing groups, materials, lines and points are skipped
+
+			p = lineEnd < end ? lineEnd + 1 : end;
+		}
+	}
+	// endregion
+
+	ObjData parseObj(std::string_view text, ThreadPool *threads) {
+		const char* begin = text.data();
+		const char* end = begin + text.size();
+
+		uint32_t chunkCount = 1;
+		if (threads)
+			chunkCount = static_cast<uint32_t>(std::clamp<size_t>(text.size() / MIN_CHUNK_BYTES, 1, (threads->size() + 1) * CHUNKS_PER_THREAD));
+
+		// Chunk boundaries moved forward to the next line start
+		std::vector<const char*> bounds(chunkCount + 1, end);
+		bounds[0] = begin;
+		for (uint32_t i = 1; i < chunkCount; i++) {
+			const char* split = std::max(begin + text.size() * i / chunkCount, bounds[i - 1]);
+			const char* lineEnd = static_cast<const char*>(memchr(split, '\n', end - split));
+			bounds[i] = lineEnd ? lineEnd + 1 : end;
+		}
+
+		std::vector<ObjChunk> chunks(chunkCount);
+		auto parse = [&](uint32_t i) { parseChunk(bounds[i], bounds[i + 1], chunks[i]); };
+		if (threads)
+			threads->parallelFor(chunkCount, parse);
+		else
+			parse(0);
+
+		// Offsets of every chunk in the merged arrays, in elements
+		struct Offsets {
+			size_t positions, normals, texCoords, corners;
+		};
+		std::vector<Offsets> offsets(chunkCount + 1, Offsets{0, 0, 0, 0});
+		for (uint32_t i = 0; i < chunkCount; i++) {
+			const ObjData& data = chunks[i].data;
+			offsets[i + 1] = {
+				offsets[i].positions + data.positions.size(),
+				offsets[i].normals + data.normals.size(),
+				offsets[i].texCoords + data.texCoords.size(),
+				offsets[i].corners + data.corners.size()
+			};
+		}
+
+		const Offsets& total = offsets[chunkCount];
+		const std::array<int32_t, 3> counts = {
+			static_cast<int32_t>(total.positions / 3),
+			static_cast<int32_t>(total.normals / 3),
+			static_cast<int32_t>(total.texCoords / 2)
+		};
+
+		ObjData merged;
+		merged.positions.resize(total.positions);
+		merged.normals.resize(total.normals);
+		merged.texCoords.resize(total.texCoords);
+		merged.corners.resize(total.corners);
+
+		auto merge = [&](uint32_t i) {
+			ObjChunk& chunk = chunks[i];
+			const Offsets& offset = offsets[i];
+			const std::array<int32_t, 3> bases = {
+				static_cast<int32_t>(offset.positions / 3),
+				static_cast<int32_t>(offset.normals / 3),
+				static_cast<int32_t>(offset.texCoords / 2)
+			};
+
+			for (const RelativeIndex& relative : chunk.relative) {
+				ObjCorner& corner = chunk.data.corners[relative.corner];
+				int32_t& index = relative.attribute == 0 ? corner.vertex : relative.attribute == 1 ? corner.normal : corner.texCoord;
+				index += bases[relative.attribute];
+			}
+
+			for (const ObjCorner& corner : chunk.data.corners) {
+				if (corner.vertex < 0 || corner.vertex >= counts[0] ||
+				    corner.normal < -1 || corner.normal >= counts[1] ||
+				    corner.texCoord < -1 || corner.texCoord >= counts[2])
+					throw std::runtime_error("OBJ face index out of range");
+			}
+
+			std::ranges::copy(chunk.data.positions, merged.positions.begin() + static_cast<std::ptrdiff_t>(offset.positions));
+			std::ranges::copy(chunk.data.normals, merged.normals.begin() + static_cast<std::ptrdiff_t>(offset.normals));
+			std::ranges::copy(chunk.data.texCoords, merged.texCoords.begin() + static_cast<std::ptrdiff_t>(offset.texCoords));
+			std::ranges::copy(chunk.data.corners, merged.corners.begin() + static_cast<std::ptrdiff_t>(offset.corners));
+			chunk = ObjChunk{};
+		};
+		if (threads)
+			threads->parallelFor(chunkCount, merge);
+		else
+			merge(0);
+
+		return merged;
+	}
+}
@@ -0,0 +1,402 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/TextureCompression.hpp>
+#include <core/utils/ImageUtils.hpp>
+#include <core/utils/ThreadPool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Core::Utils {
+
+	// 4x4 RGBA texels in row order
+	using Block = std::array<std::array<uint8_t, 4>, 16>;
+
+	// region Helpers
+	static Block extractBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY) {
+		// Blocks hanging over the edge repeat the last row and column
+		Block block;
+		for (uint32_t y = 0; y < 4; y++) {
+			const uint32_t sy = std::min(blockY * 4 + y, height - 1);
+			for (uint32_t x = 0; x < 4; x++) {
+				const uint32_t sx = std::min(blockX * 4 + x, width - 1);
+				memcpy(block[y * 4 + x].data(), pixels + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+			}
+		}
+		return block;
+	}
+
+	// Principal axis of the first N channels of the block by power iteration on their covariance
+	template<int N>
+	static void principalAxis(const Block& block, std::array<float, N>& mean, std::array<float, N>& axis) {
+		mean.fill(0.0f);
+		for (const auto& texel : block)
+			for (int c = 0; c < N; c++)
+				mean[c] += texel[c];
+		for (int c = 0; c < N; c++)
+			mean[c] /= 16.0f;
+
+		std::array<std::array<float, N>, N> covariance{};
+		for (const auto& texel : block) {
+			std::array<float, N> d;
+			for (int c = 0; c < N; c++)
+				d[c] = texel[c] - mean[c];
+			for (int i = 0; i < N; i++)
+				for (int j = 0; j < N; j++)
+					covariance[i][j] += d[i] * d[j];
+		}
+
+		axis.fill(1.0f);
+		for (int iteration = 0; iteration < 8; iteration++) {
+			std::array<float, N> next{};
+			for (int i = 0; i < N; i++)
+				for (int j = 0; j < N; j++)
+					next[i] += covariance[i][j] * axis[j];
+
+			float length = 0.0f;
+			for (float v : next)
+				length += v * v;
+			length = std::sqrt(length);
+			if (length < 1e-6f)
+				return; // flat block, any axis works
+			for (int c = 0; c < N; c++)
+				axis[c] = next[c] / length;
+		}
+	}
+
+	// Writes values LSB first across the block
+	struct BitWriter {
+		uint8_t* out;
+		uint32_t position = 0;
+
+		void write(uint32_t value, uint32_t bits) {
+			for (uint32_t i = 0; i < bits; i++, position++)
+				if ((value >> i) & 1u)
+					out[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+		}
+	};
+	// endregion
+
+	// region BC1
+	static std::array<int, 3> expand565(uint16_t color) {
+		const int r = (color >> 11) & 31;
+		const int g = (color >> 5) & 63;
+		const int b = color & 31;
+		return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+	}
+
+	static uint16_t quantize565(float r, float g, float b) {
+		const auto q = [](float v, int max) { return static_cast<uint16_t>(std::clamp(static_cast<int>(v * max / 255.0f + 0.5f), 0, max)); };
+		return static_cast<uint16_t>(q(r, 31) << 11 | q(g, 63) << 5 | q(b, 31));
+	}
+
+	// Four color palette with c0 > c1, returns the squared error of the best indices
+	static int chooseBC1Indices(const Block& block, uint16_t c0, uint16_t c1, std::array<uint8_t, 16>& indices) {
+		const auto e0 = expand565(c0);
+		const auto e1 = expand565(c1);
+		std::array<std::array<int, 3>, 4> palette;
+		for (int c = 0; c < 3; c++) {
+			palette[0][c] = e0[c];
+			palette[1][c] = e1[c];
+			palette[2][c] = (2 * e0[c] + e1[c]) / 3;
+			palette[3][c] = (e0[c] + 2 * e1[c]) / 3;
+		}
+
+		int total = 0;
+		for (int i = 0; i < 16; i++) {
+			int best = INT32_MAX;
+			for (uint8_t p = 0; p < 4; p++) {
+				int error = 0;
+				for (int c = 0; c < 3; c++) {
+					const int d = block[i][c] - palette[p][c];
+					error += d * d;
+				}
+				if (error < best) {
+					best = error;
+					indices[i] = p;
+				}
+			}
+			total += best;
+		}
+		return total;
+	}
+
+	// Least squares endpoints for fixed indices
+	static bool fitBC1Endpoints(const Block& block, const std::array<uint8_t, 16>& indices, uint16_t& c0, uint16_t& c1) {
+		static constexpr float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+		float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+		std::array<float, 3> ax{}, bx{};
+		for (int i = 0; i < 16; i++) {
+			const float a = weights[indices[i]];
+			const float b = 1.0f - a;
+			aa += a * a;
+			bb += b * b;
+			ab += a * b;
+			for (int c = 0; c < 3; c++) {
+				ax[c] += a * block[i][c];
+				bx[c] += b * block[i][c];
+			}
+		}
+
+		const float det = aa * bb - ab * ab;
+		if (std::abs(det) < 1e-6f)
+			return false;
+
+		std::array<float, 3> e0, e1;
+		for (int c = 0; c < 3; c++) {
+			e0[c] = (ax[c] * bb - bx[c] * ab) / det;
+			e1[c] = (bx[c] * aa - ax[c] * ab) / det;
+		}
+		c0 = quantize565(e0[0], e0[1], e0[2]);
+		c1 = quantize565(e1[0], e1[1], e1[2]);
+		return true;
+	}
+
+	static void encodeBC1(const Block& block, uint8_t* out) {
+		std::array<float, 3> mean, axis;
+		principalAxis<3>(block, mean, axis);
+
+		float minT = FLT_MAX, maxT = -FLT_MAX;
+		for (const auto& texel : block) {
+			float t = 0.0f;
+			for (int c = 0; c < 3; c++)
+				t += (texel[c] - mean[c]) * axis[c];
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		uint16_t c0 = quantize565(mean[0] + axis[0] * maxT, mean[1] + axis[1] * maxT, mean[2] + axis[2] * maxT);
+		uint16_t c1 = quantize565(mean[0] + axis[0] * minT, mean[1] + axis[1] * minT, mean[2] + axis[2] * minT);
+
+		std::array<uint8_t, 16> indices{};
+		int error = chooseBC1Indices(block, c0, c1, indices);
+
+		// One refinement pass, kept only when it lowers the error
+		uint16_t r0, r1;
+		if (fitBC1Endpoints(block, indices, r0, r1)) {
+			std::array<uint8_t, 16> refined{};
+			const int refinedError = chooseBC1Indices(block, r0, r1, refined);
+			if (refinedError < error) {
+				c0 = r0;
+				c1 = r1;
+				indices = refined;
+				error = refinedError;
+			}
+		}
+
+		// Four color mode needs c0 > c1, equal endpoints decode index 0 the same in either mode
+		if (c0 < c1) {
+			std::swap(c0, c1);
+			for (auto& index : indices)
+				index = static_cast<uint8_t>(index ^ 1);
+		} else if (c0 == c1) {
+			indices.fill(0);
+		}
+
+		memset(out, 0, 8);
+		BitWriter writer{out};
+		writer.write(c0, 16);
+		writer.write(c1, 16);
+		for (uint8_t index : indices)
+			writer.write(index, 2);
+	}
+	// endregion
+
+	// region BC4
+	// One channel: eight values between the extremes, a0 > a1
+	static void encodeBC4(const std::array<uint8_t, 16>& values, uint8_t* out) {
+		const auto [minIt, maxIt] = std::minmax_element(values.begin(), values.end());
+		const int a0 = *maxIt;
+		const int a1 = *minIt;
+
+		memset(out, 0, 8);
+		BitWriter writer{out};
+		writer.write(a0, 8);
+		writer.write(a1, 8);
+
+		for (uint8_t value : values) {
+			uint32_t index = 0;
+			if (a0 != a1) {
+				// Position 0 is a1 and 7 is a0, index 0 and 1 hold the extremes and 2..7 the ramp from a0 down
+				const int position = ((value - a1) * 14 + (a0 - a1)) / (2 * (a0 - a1));
+				index = position == 7 ? 0 : position == 0 ? 1 : 8 - position;
+			}
+			writer.write(index, 3);
+		}
+	}
+
+	static void encodeBC4Channel(const Block& block, int channel, uint8_t* out) {
+		std::array<uint8_t, 16> values;
+		for (int i = 0; i < 16; i++)
+			values[i] = block[i][channel];
+		encodeBC4(values, out);
+	}
+	// endregion
+
+	// region BC7
+	// Mode 6: one subset, RGBA endpoints of 7 bits plus a shared low bit each, 4 bit indices
+	static void encodeBC7(const Block& block, uint8_t* out) {
+		static constexpr int weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+		std::array<float, 4> mean, axis;
+		principalAxis<4>(block, mean, axis);
+
+		float minT = FLT_MAX, maxT = -FLT_MAX;
+		for (const auto& texel : block) {
+			float t = 0.0f;
+			for (int c = 0; c < 4; c++)
+				t += (texel[c] - mean[c]) * axis[c];
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		// Quantize both endpoints, picking the low bit that lands closest
+		std::array<std::array<int, 4>, 2> quantized;
+		std::array<int, 2> pbits;
+		const float extremes[2] = {minT, maxT};
+		for (int e = 0; e < 2; e++) {
+			int bestError = INT32_MAX;
+			for (int p = 0; p < 2; p++) {
+				std::array<int, 4> q;
+				int error = 0;
+				for (int c = 0; c < 4; c++) {
+					const float target = std::clamp(mean[c] + axis[c] * extremes[e], 0.0f, 255.0f);
+					q[c] = std::clamp(static_cast<int>((target - p) / 2.0f + 0.5f), 0, 127);
+					const int d = ((q[c] << 1) | p) - static_cast<int>(target + 0.5f);
+					error += d * d;
+				}
+				if (error < bestError) {
+					bestError = error;
+					quantized[e] = q;
+					pbits[e] = p;
+				}
+			}
+		}
+
+		std::array<std::array<int, 4>, 16> palette;
+		for (int i = 0; i < 16; i++)
+			for (int c = 0; c < 4; c++) {
+				const int e0 = (quantized[0][c] << 1) | pbits[0];
+				const int e1 = (quantized[1][c] << 1) | pbits[1];
+				palette[i][c] = ((64 - weights[i]) * e0 + weights[i] * e1 + 32) >> 6;
+			}
+
+		std::array<uint32_t, 16> indices{};
+		for (int i = 0; i < 16; i++) {
+			int best = INT32_MAX;
+			for (uint32_t p = 0; p < 16; p++) {
+				int error = 0;
+				for (int c = 0; c < 4; c++) {
+					const int d = block[i][c] - palette[p][c];
+					error += d * d;
+				}
+				if (error < best) {
+					best = error;
+					indices[i] = p;
+				}
+			}
+		}
+
+		// The first index is stored without its top bit, swapping the endpoints mirrors every index
+		if (indices[0] >= 8) {
+			std::swap(quantized[0], quantized[1]);
+			std::swap(pbits[0], pbits[1]);
+			for (auto& index : indices)
+				index = 15 - index;
+		}
+
+		memset(out, 0, 16);
+		BitWriter writer{out};
+		writer.write(1u << 6, 7);
+		for (int c = 0; c < 4; c++) {
+			writer.write(quantized[0][c], 7);
+			writer.write(quantized[1][c], 7);
+		}
+		writer.write(pbits[0], 1);
+		writer.write(pbits[1], 1);
+		writer.write(indices[0], 3);
+		for (int i = 1; i < 16; i++)
+			writer.write(indices[i], 4);
+	}
+	// endregion
+
+	static void encodeBlock(const Block& block, TextureFormat format, uint8_t* out) {
+		switch (format) {
+			case TextureFormat::BC1Srgb:
+				encodeBC1(block, out);
+				break;
+			case TextureFormat::BC3Srgb:
+				encodeBC4Channel(block, 3, out);
+				encodeBC1(block, out + 8);
+				break;
+			case TextureFormat::BC5Unorm:
+				encodeBC4Channel(block, 0, out);
+				encodeBC4Channel(block, 1, out + 8);
+				break;
+			case TextureFormat::BC7Srgb:
+				encodeBC7(block, out);
+				break;
+			default:
+				throw std::runtime_error("not a block compressed format");
+		}
+	}
+
+	TextureData compressTexture(const TextureData& rgba, TextureFormat format, ThreadPool* threads) {
+		if (rgba.format != TextureFormat::RGBA8Srgb)
+			throw std::runtime_error("only RGBA8 textures can be compressed");
+		if (!isBlockCompressed(format))
+			throw std::runtime_error("not a block compressed format");
+
+		TextureData compressed{
+			.pixels = {},
+			.width = rgba.width,
+			.height = rgba.height,
+			.nbChannels = rgba.nbChannels,
+			.mipLevels = rgba.mipLevels,
+			.format = format
+		};
+
+		size_t compressedSize = 0;
+		for (uint32_t level = 0; level < rgba.mipLevels; level++)
+			compressedSize += mipLevelSize(format, std::max(rgba.width >> level, 1u), std::max(rgba.height >> level, 1u));
+		compressed.pixels.resize(compressedSize);
+
+		const uint32_t blockBytes = formatBlockBytes(format);
+		size_t compressedOffset = 0;
+
+		for (uint32_t level = 0; level < rgba.mipLevels; level++) {
+			const uint32_t width = std::max(rgba.width >> level, 1u);
+			const uint32_t height = std::max(rgba.height >> level, 1u);
+			const uint32_t blocksX = (width + 3) / 4;
+			const uint32_t blocksY = (height + 3) / 4;
+
+			const uint8_t* source = rgba.data().data() + mipLevelOffset(rgba, level);
+			uint8_t* destination = compressed.pixels.data() + compressedOffset;
+
+			// Each row of blocks writes its own range of the output
+			auto encodeRow = [&](uint32_t blockY) {
+				for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+					const Block block = extractBlock(source, width, height, blockX, blockY);
+					encodeBlock(block, format, destination + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes);
+				}
+			};
+
+			if (threads)
+				threads->parallelFor(blocksY, encodeRow);
+			else
+				for (uint32_t blockY = 0; blockY < blocksY; blockY++)
+					encodeRow(blockY);
+
+			compressedOffset += mipLevelSize(format, width, height);
+		}
+
+		return compressed;
+	}
+}
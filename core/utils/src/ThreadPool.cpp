@@ -0,0 +1,160 @@
+//
+// Created by eharquin on 10/17/26.
+//
+
+#include <core/utils/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+
+namespace Core::Utils {
+
+	uint32_t ThreadPool::defaultThreadCount() {
+		const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		return std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+	}
+
+	// Worker running on this thread, submit uses it to keep nested tasks local
+	static thread_local const ThreadPool* currentPool = nullptr;
+	static thread_local uint32_t currentWorker = 0;
+
+	ThreadPool::ThreadPool(uint32_t threadCount) {
+		_queues.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+			_queues.push_back(std::make_unique<Queue>());
+
+		_workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+			_workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard lock(_mutex);
+			_stopping = true;
+		}
+		_condition.notify_all();
+
+		for (auto& worker : _workers)
+			worker.join();
+	}
+
+	std::future<void> ThreadPool::submit(std::function<void()> task) {
+		std::packaged_task<void()> packaged(std::move(task));
+		std::future<void> future = packaged.get_future();
+
+		if (_queues.empty()) {
+			packaged();
+			return future;
+		}
+
+		const uint32_t index = currentPool == this
+			? currentWorker
+			: _nextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<uint32_t>(_queues.size());
+		{
+			std::lock_guard lock(_queues[index]->mutex);
+			_queues[index]->tasks.push_back(std::move(packaged));
+		}
+		{
+			// Raised under the sleep mutex so a worker about to wait cannot miss it
+			std::lock_guard lock(_mutex);
+			_pending.fetch_add(1);
+		}
+		_condition.notify_one();
+		return future;
+	}
+
+	void ThreadPool::parallelFor(uint32_t count, const std::function<void(uint32_t)>& task) {
+		if (count == 0)
+			return;
+
+		std::atomic<uint32_t> next{0};
+		auto run = [&next, count, &task] {
+			for (uint32_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+				task(i);
+		};
+
+		// The calling thread takes part, so only count - 1 helpers are useful
+		const uint32_t helperCount = std::min(size(), count - 1);
+		std::vector<std::future<void>> helpers;
+		helpers.reserve(helperCount);
+		for (uint32_t i = 0; i < helperCount; i++)
+			helpers.push_back(submit(run));
+
+		std::exception_ptr error;
+		try {
+			run();
+		} catch (...) {
+			error = std::current_exception();
+		}
+
+		// Helpers reference this stack frame, wait for all of them even after a failure. A worker of this pool
+		// runs queued tasks meanwhile, its own helpers may still sit in its queue.
+		for (auto& helper : helpers) {
+			while (currentPool == this && helper.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				std::packaged_task<void()> queued;
+				if (popTask(currentWorker, queued))
+					queued();
+				else
+					std::this_thread::yield();
+			}
+
+			try {
+				helper.get();
+			} catch (...) {
+				if (!error)
+					error = std::current_exception();
+			}
+		}
+
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	bool ThreadPool::popTask(uint32_t index, std::packaged_task<void()>& task) {
+		{
+			Queue& own = *_queues[index];
+			std::lock_guard lock(own.mutex);
+			if (!own.tasks.empty()) {
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				_pending.fetch_sub(1);
+				return true;
+			}
+		}
+
+		const auto queueCount = static_cast<uint32_t>(_queues.size());
+		for (uint32_t offset = 1; offset < queueCount; offset++) {
+			Queue& victim = *_queues[(index + offset) % queueCount];
+			std::lock_guard lock(victim.mutex);
+			if (!victim.tasks.empty()) {
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				_pending.fetch_sub(1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::workerLoop(uint32_t index) {
+		currentPool = this;
+		currentWorker = index;
+
+		while (true) {
+			std::packaged_task<void()> task;
+			if (popTask(index, task)) {
+				task();
+				continue;
+			}
+
+			// _pending may briefly count a task another worker is taking, the next pass sorts it out
+			std::unique_lock lock(_mutex);
+			_condition.wait(lock, [this] { return _stopping || _pending.load() > 0; });
+			if (_stopping && _pending.load() <= 0)
+				return;
+		}
+	}
+}
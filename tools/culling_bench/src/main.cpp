@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <core/rendering/vulkan/Culling.hpp>
+
+using namespace Core::Rendering::Vulkan;
+
+static void printUsage() {
+	std::cerr << "usage: astroCullingBench [spheres] [iterations]" << std::endl;
+}
+
+// 90 degree frustum at the origin looking down -z, from 0.1 to 100 units
+static FrustumPlanes benchFrustum() {
+	const float side = 1.0f / std::sqrt(2.0f);
+	return {
+		glm::vec4(side, 0.0f, -side, 0.0f),
+		glm::vec4(-side, 0.0f, -side, 0.0f),
+		glm::vec4(0.0f, side, -side, 0.0f),
+		glm::vec4(0.0f, -side, -side, 0.0f),
+		glm::vec4(0.0f, 0.0f, -1.0f, -0.1f),
+		glm::vec4(0.0f, 0.0f, 1.0f, 100.0f)
+	};
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 3) {
+		printUsage();
+		return 1;
+	}
+
+	try
+	{
+		const uint32_t sphereCount = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 100000;
+		const uint32_t iterations = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 200;
+
+		// Fixed seed so every run and every kernel sees the same scene
+		std::mt19937 random(1234);
+		std::uniform_real_distribution position(-100.0f, 100.0f);
+		std::uniform_real_distribution radius(0.1f, 2.0f);
+
+		SphereBounds bounds;
+		bounds.reserve(sphereCount);
+		for (uint32_t i = 0; i < sphereCount; i++)
+			bounds.push(glm::vec3(position(random), position(random), position(random)), radius(random));
+
+		const FrustumPlanes planes = benchFrustum();
+		std::vector<uint32_t> visible(sphereCount);
+		std::vector<uint32_t> reference;
+		bool hasReference = false;
+
+		std::cout << sphereCount << " spheres, " << iterations << " iterations, best kernel "
+				<< cullingKernelName(bestCullingKernel()) << std::endl;
+
+		// Kernels wider than the running CPU supports are skipped
+		for (const CullingKernel kernel : {CullingKernel::Scalar, CullingKernel::SSE, CullingKernel::AVX2}) {
+			if (kernel > bestCullingKernel())
+				continue;
+
+			uint32_t visibleCount = cullSpheres(bounds, planes, visible.data(), kernel); // warm up
+
+			const auto start = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < iterations; i++)
+				visibleCount = cullSpheres(bounds, planes, visible.data(), kernel);
+			const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+			// Every kernel must agree with the scalar one
+			if (!hasReference) {
+				reference.assign(visible.begin(), visible.begin() + visibleCount);
+				hasReference = true;
+			} else if (!std::equal(reference.begin(), reference.end(), visible.begin(), visible.begin() + visibleCount))
+				throw std::runtime_error(std::string(cullingKernelName(kernel)) + " kernel disagrees with the scalar one");
+
+			std::cout << cullingKernelName(kernel) << ": " << ns / (static_cast<double>(iterations) * sphereCount)
+					<< " ns/instance, " << visibleCount << " visible" << std::endl;
+		}
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
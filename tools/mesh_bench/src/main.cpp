@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <core/common/RenderTypes.hpp>
+#include <core/utils/FlatHashMap.hpp>
+#include <core/utils/ObjParser.hpp>
+#include <core/utils/ThreadPool.hpp>
+
+using namespace Core;
+
+// region Allocation tracking
+// Every allocation of the tool goes through these, so a phase's peak is the high water mark above the bytes
+// live when it started
+static std::atomic<size_t> liveBytes = 0;
+static std::atomic<size_t> peakBytes = 0;
+
+// Keeps max_align_t alignment for the block behind the size header
+static constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+	auto* block = static_cast<char*>(std::malloc(size + ALLOCATION_HEADER));
+	if (!block)
+		throw std::bad_alloc();
+	*reinterpret_cast<size_t*>(block) = size;
+
+	const size_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	size_t peak = peakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+	return block + ALLOCATION_HEADER;
+}
+
+void operator delete(void* pointer) noexcept {
+	if (!pointer)
+		return;
+	char* block = static_cast<char*>(pointer) - ALLOCATION_HEADER;
+	liveBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+	std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+	operator delete(pointer);
+}
+
+struct PhaseResult {
+	double ms;
+	size_t peakBytes;
+};
+
+template <typename Function>
+static PhaseResult measure(Function&& function) {
+	const size_t baseline = liveBytes.load();
+	peakBytes = baseline;
+
+	const auto start = std::chrono::steady_clock::now();
+	function();
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return {ms, peakBytes.load() - baseline};
+}
+// endregion
+
+static void printUsage() {
+	std::cerr << "usage: astroMeshBench [gridSize]" << std::endl;
+}
+
+// Square grid of gridSize x gridSize quads with one position, normal and texture coordinate per grid point
+static std::string generateGridObj(uint32_t gridSize) {
+	const uint32_t side = gridSize + 1;
+	std::ostringstream obj;
+
+	for (uint32_t y = 0; y < side; y++)
+		for (uint32_t x = 0; x < side; x++)
+			obj << "v " << x << ' ' << y << " 0\n";
+	for (uint32_t y = 0; y < side; y++)
+		for (uint32_t x = 0; x < side; x++)
+			obj << "vt " << static_cast<float>(x) / gridSize << ' ' << static_cast<float>(y) / gridSize << '\n';
+	obj << "vn 0 0 1\n";
+
+	for (uint32_t y = 0; y < gridSize; y++) {
+		for (uint32_t x = 0; x < gridSize; x++) {
+			const uint32_t a = y * side + x + 1;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + side + 1;
+			const uint32_t d = a + side;
+			obj << "f " << a << '/' << a << "/1 " << b << '/' << b << "/1 " << c << '/' << c << "/1 " << d << '/' << d << "/1\n";
+		}
+	}
+	return obj.str();
+}
+
+static Vertex buildVertex(const Utils::ObjData& obj, const Utils::ObjCorner& corner) {
+	Vertex vertex{};
+	vertex.pos = {obj.positions[3 * corner.vertex + 0], obj.positions[3 * corner.vertex + 1], obj.positions[3 * corner.vertex + 2]};
+	vertex.texCoord = {obj.texCoords[2 * corner.texCoord + 0], 1.0f - obj.texCoords[2 * corner.texCoord + 1]};
+	vertex.color = {1.0f, 1.0f, 1.0f};
+	vertex.normal = {obj.normals[3 * corner.normal + 0], obj.normals[3 * corner.normal + 1], obj.normals[3 * corner.normal + 2]};
+	return vertex;
+}
+
+// The loader before FlatHashMap: every corner builds its vertex and looks it up in a node based map
+static MeshData dedupVertexMap(const Utils::ObjData& obj) {
+	MeshData mesh;
+	std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+
+	for (const Utils::ObjCorner& corner : obj.corners) {
+		const Vertex vertex = buildVertex(obj, corner);
+		if (!uniqueVertices.contains(vertex)) {
+			uniqueVertices[vertex] = static_cast<uint32_t>(mesh.vertices.size());
+			mesh.vertices.push_back(vertex);
+		}
+		mesh.indices.push_back(uniqueVertices[vertex]);
+	}
+	return mesh;
+}
+
+// The current loader: one probe per corner on its index triplet, vertices built once per unique corner
+static MeshData dedupCornerMap(const Utils::ObjData& obj) {
+	MeshData mesh;
+	Utils::FlatHashMap<Utils::ObjCorner, uint32_t, Utils::ObjCornerHash> uniqueVertices(obj.corners.size() / 3);
+	std::vector<Utils::ObjCorner> uniqueCorners;
+	uniqueCorners.reserve(obj.corners.size() / 3);
+	mesh.indices.reserve(obj.corners.size());
+
+	for (const Utils::ObjCorner& corner : obj.corners) {
+		const auto [slot, inserted] = uniqueVertices.tryEmplace(corner, static_cast<uint32_t>(uniqueCorners.size()));
+		if (inserted)
+			uniqueCorners.push_back(corner);
+		mesh.indices.push_back(slot);
+	}
+
+	mesh.vertices.reserve(uniqueCorners.size());
+	for (const Utils::ObjCorner& corner : uniqueCorners)
+		mesh.vertices.push_back(buildVertex(obj, corner));
+	return mesh;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 2) {
+		printUsage();
+		return 1;
+	}
+
+	try
+	{
+		const uint32_t gridSize = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 512;
+
+		const std::string text = generateGridObj(gridSize);
+		const double megabytes = text.size() / (1024.0 * 1024.0);
+
+		// Single threaded, then split into chunks over the pool with the calling thread taking part
+		Utils::ObjData obj;
+		const PhaseResult serialParse = measure([&] { obj = Utils::parseObj(text); });
+		Utils::ThreadPool threads;
+		const PhaseResult parallelParse = measure([&] { obj = Utils::parseObj(text, &threads); });
+
+		std::cout << gridSize << "x" << gridSize << " grid, " << obj.corners.size() / 3 << " triangles, "
+				<< megabytes << " MB of OBJ" << std::endl;
+		std::cout << "parseObj on 1 thread:  " << serialParse.ms << " ms (" << megabytes / (serialParse.ms / 1000.0) << " MB/s)" << std::endl;
+		std::cout << "parseObj on " << threads.size() + 1 << " threads: " << parallelParse.ms << " ms ("
+				<< megabytes / (parallelParse.ms / 1000.0) << " MB/s)" << std::endl;
+
+		// The peaks cover the map and the mesh each deduplication builds
+		MeshData viaVertex;
+		MeshData viaCorner;
+		const PhaseResult vertexMap = measure([&] { viaVertex = dedupVertexMap(obj); });
+		const PhaseResult cornerMap = measure([&] { viaCorner = dedupCornerMap(obj); });
+		if (viaVertex.indices != viaCorner.indices || viaVertex.vertices != viaCorner.vertices)
+			throw std::runtime_error("both deduplications must build the same mesh");
+
+		std::cout << "unordered_map<Vertex>:  " << vertexMap.ms << " ms, " << vertexMap.peakBytes << " peak bytes" << std::endl;
+		std::cout << "FlatHashMap<ObjCorner>: " << cornerMap.ms << " ms, " << cornerMap.peakBytes << " peak bytes" << std::endl;
+		std::cout << viaCorner.vertices.size() << " unique vertices" << std::endl;
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
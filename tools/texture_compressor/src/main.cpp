@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <core/utils/ImageUtils.hpp>
+#include <core/utils/Ktx2.hpp>
+#include <core/utils/TextureCompression.hpp>
+#include <core/utils/ThreadPool.hpp>
+
+using namespace Core;
+
+static void printUsage() {
+	std::cerr << "usage: astroTextureCompressor <input.png|jpg> <output.ktx2> [--format bc1|bc3|bc5|bc7] [--threads N] [--no-mips]" << std::endl;
+}
+
+static TextureFormat parseFormat(const std::string &name) {
+	if (name == "bc1") return TextureFormat::BC1Srgb;
+	if (name == "bc3") return TextureFormat::BC3Srgb;
+	if (name == "bc5") return TextureFormat::BC5Unorm;
+	if (name == "bc7") return TextureFormat::BC7Srgb;
+	throw std::runtime_error("unknown format: " + name);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3) {
+		printUsage();
+		return 1;
+	}
+
+	try
+	{
+		const std::string input = argv[1];
+		const std::string output = argv[2];
+		TextureFormat format = TextureFormat::BC7Srgb;
+		uint32_t threadCount = Utils::ThreadPool::defaultThreadCount();
+		bool mips = true;
+
+		for (int i = 3; i < argc; i++) {
+			if (!strcmp(argv[i], "--format") && i + 1 < argc)
+				format = parseFormat(argv[++i]);
+			else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+				threadCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (!strcmp(argv[i], "--no-mips"))
+				mips = false;
+			else {
+				printUsage();
+				return 1;
+			}
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+
+		TextureData texture = Utils::readTexture(input);
+		if (mips)
+			Utils::generateMipChain(texture);
+
+		// The calling thread encodes too
+		Utils::ThreadPool threads(threadCount);
+		const TextureData compressed = Utils::compressTexture(texture, format, &threads);
+		Utils::writeKtx2(output, compressed);
+
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::cout << input << " -> " << output << ": " << texture.width << "x" << texture.height
+				<< ", " << compressed.mipLevels << " levels, " << texture.data().size() << " -> " << compressed.pixels.size()
+				<< " bytes in " << ms << " ms on " << threads.size() + 1 << " threads" << std::endl;
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}